@@ -1,36 +1,124 @@
 #include "app.h"
+#include "../utility/memory_stats.h"
+#include "../utility/trace.h"
 #include "ui.h"
 #include "communication.h"
 #include "data.h"
+#include "glance.h"
+#include "scheduler.h"
 
-static void hour_tick_handler(struct tm *tick_time, TimeUnits units_changed)
+// A launch by the background worker or a wakeup only refreshes the scores, then gets out of the way. The phone may
+// retry a slow forecast request a few times before it syncs.
+#define QUIET_POLL_MS 1000
+#define QUIET_TIMEOUT_MS 45000
+
+static AppTimer *s_quiet_timer;
+static uint32_t s_quiet_elapsed_ms;
+// Whether the launch went on to refresh, rather than closing straight after loading the data
+static bool s_refreshing;
+
+static void quiet_timer_callback(void *context)
 {
-    if (units_changed & HOUR_UNIT)
+    s_quiet_timer = NULL;
+    s_quiet_elapsed_ms += QUIET_POLL_MS;
+
+    // The phone fetches before a quiet launch's sync, so once one completes the scores are as fresh as they get
+    if (is_data_synced() || s_quiet_elapsed_ms >= QUIET_TIMEOUT_MS ||
+        !connection_service_peek_pebble_app_connection())
+    {
+        window_stack_pop_all(false);
+        return;
+    }
+    s_quiet_timer = app_timer_register(QUIET_POLL_MS, quiet_timer_callback, NULL);
+}
+
+// Keeps the scores warm while the app is closed, see worker_src. Starting it may put up a confirmation dialog, so
+// only a launch by the user does, and only once: the system does not say whether the user declined.
+static bool start_worker(AppLaunchReason reason)
+{
+    if (app_worker_is_running())
+        return true;
+
+    PersistedWorker worker = {0};
+    persist_read_data(PERSIST_KEY_WORKER, &worker, sizeof(worker));
+    if (reason != APP_LAUNCH_USER || worker.launch_asked)
+        return false;
+
+    AppWorkerResult result = app_worker_launch();
+    if (result == APP_WORKER_RESULT_SUCCESS || result == APP_WORKER_RESULT_ALREADY_RUNNING)
+        return true;
+
+    if (result == APP_WORKER_RESULT_ASKING_CONFIRMATION)
+    {
+        worker.launch_asked = true;
+        persist_write_data(PERSIST_KEY_WORKER, &worker, sizeof(worker));
+    }
+    else
     {
-        send_update_all_message();
+        APP_LOG(APP_LOG_LEVEL_ERROR, "[Worker] Launch failed: %d", result);
     }
+    return false;
 }
 
 static void init(void)
 {
+    const AppLaunchReason reason = launch_reason();
+    const bool quiet = reason == APP_LAUNCH_WORKER || reason == APP_LAUNCH_WAKEUP;
+
+    memory_stats_log("start");
     data_init();
+    memory_stats_log("data_init");
+    const bool worker_running = start_worker(reason);
+
+    // Without the phone there is nothing to refresh. The worker only launches when a refresh is due, a wakeup fires
+    // regardless and checks here. Both are decided before anything is sent, and without a window the app closes.
+    if (quiet && (!connection_service_peek_pebble_app_connection() ||
+                  (reason == APP_LAUNCH_WAKEUP && !scheduler_claim_wakeup_launch())))
+    {
+        scheduler_register_wakeups(worker_running);
+        return;
+    }
+
     ui_init();
-    communication_init();
-    tick_timer_service_subscribe(HOUR_UNIT, hour_tick_handler);
+    memory_stats_log("ui_init");
+    communication_init(quiet);
+    memory_stats_log("communication_init");
+    scheduler_init(worker_running);
+    memory_stats_log("scheduler_init");
+    s_refreshing = true;
+
+    if (quiet)
+    {
+        s_quiet_timer = app_timer_register(QUIET_POLL_MS, quiet_timer_callback, NULL);
+    }
 }
 
 static void deinit(void)
 {
-    communication_deinit();
-    ui_deinit();
+    if (s_quiet_timer)
+    {
+        app_timer_cancel(s_quiet_timer);
+        s_quiet_timer = NULL;
+    }
+    // Runs on every exit, which includes the end of each quiet refresh
+    glance_publish();
+    if (s_refreshing)
+    {
+        scheduler_deinit();
+        communication_deinit();
+        ui_deinit();
+    }
     data_deinit();
-    tick_timer_service_unsubscribe();
+    memory_stats_log("deinit");
 }
 
 int main(void)
 {
+    trace_mark(TRACE_MAIN);
     init();
+    trace_mark(TRACE_INIT_DONE);
     app_event_loop();
     deinit();
+    trace_dump();
     return 0;
 }
@@ -1,106 +1,340 @@
 #include "communication.h"
+#include "../utility/memory_stats.h"
+#include "../utility/trace.h"
 #include "data.h"
+#include "protocol.h"
+#include "transfer.h"
 #include "ui.h"
 #include <pebble-events/pebble-events.h>
 
-static void inbox_received_callback(DictionaryIterator *iter, void *context)
+#define INBOX_SIZE 128
+#define OUTBOX_SIZE 128
+#define OUTBOX_QUEUE_SIZE 4
+#define RETRY_INITIAL_MS 500
+#define RETRY_MAX_MS 30000
+#define RETRY_MAX_ATTEMPTS 5
+
+// Messages waiting for the phone, the head is the one being sent
+static Opcode s_outbox[OUTBOX_QUEUE_SIZE];
+static uint8_t s_outbox_count;
+static bool s_outbox_in_flight;
+static uint32_t s_retry_ms = RETRY_INITIAL_MS;
+static uint8_t s_retry_attempts;
+static AppTimer *s_retry_timer;
+static bool s_fetch_first;
+#ifdef TRACE
+// The next update request sent answers the phone's OP_READY, which traces it apart from the scheduler's refreshes
+static bool s_ready_update_pending;
+#endif
+
+static EventHandle s_inbox_received_handle;
+static EventHandle s_outbox_sent_handle;
+static EventHandle s_outbox_failed_handle;
+
+static bool queue_message(Opcode op);
+
+// Hourly scores for any number of regions and days, each record headed by where its hours start
+static bool handle_timeline(const uint8_t *data, uint16_t length)
+{
+    bool changed = false;
+    uint16_t offset = 0;
+    while (offset + TIMELINE_HEADER_SIZE <= length)
+    {
+        const Region region = (Region)data[offset];
+        const uint8_t day = data[offset + 1];
+        const uint8_t start_hour = data[offset + 2];
+        const uint8_t count = data[offset + 3];
+        offset += TIMELINE_HEADER_SIZE;
+        if (offset + count > length)
+            break;
+
+        // One byte per hour from the phone, packed into nibbles by the data store
+        changed |= set_hourly_scores(region, day, start_hour, data + offset, count);
+        offset += count;
+    }
+    return changed;
+}
+
+// Sequence numbers skip 0, which stands for a watch that has nothing to build on
+static uint16_t get_next_sequence(uint16_t sequence)
+{
+    return (sequence == UINT16_MAX) ? 1 : sequence + 1;
+}
+
+// Applies a payload that starts with the protocol header, whether it came in one message or in chunks
+static void handle_payload(Opcode op, const uint8_t *payload, uint16_t payload_length)
 {
-    Tuple *type_tuple = dict_find(iter, MESSAGE_KEY_type);
-    if (!type_tuple)
+    if (payload_length < PAYLOAD_HEADER_SIZE)
         return;
 
-    if (strcmp(type_tuple->value->cstring, "ready") == 0)
+    if (payload[0] != PROTOCOL_VERSION)
     {
-        send_update_all_message();
+        APP_LOG(APP_LOG_LEVEL_ERROR, "[AppMessage] Unsupported protocol version: %d", payload[0]);
         return;
     }
 
-    if (strcmp(type_tuple->value->cstring, "new_score") == 0)
+    // Updates only hold what changed, so they have to be applied in order without gaps
+    const uint16_t sequence = (payload[1] << 8) | payload[2];
+    const uint8_t flags = payload[3];
+    if (!(flags & SYNC_FLAG_RESET) && sequence != get_next_sequence(get_data_sequence()))
     {
-        Tuple *region_tuple = dict_find(iter, MESSAGE_KEY_region);
-        Tuple *time_tuple = dict_find(iter, MESSAGE_KEY_time);
-        Tuple *score_tuple = dict_find(iter, MESSAGE_KEY_score);
+        APP_LOG(APP_LOG_LEVEL_ERROR, "[AppMessage] Missed an update: %d after %d", sequence, get_data_sequence());
+        queue_message(OP_RESYNC);
+        return;
+    }
 
-        if (region_tuple && time_tuple && score_tuple)
-        {
-            Region region = (strcmp(region_tuple->value->cstring, "north") == 0) ? REGION_NORTH : REGION_SOUTH;
-            TimePeriod time = (strcmp(time_tuple->value->cstring, "morning") == 0) ? TIME_MORNING : TIME_AFTERNOON;
-            int8_t score = (int8_t)score_tuple->value->int32;
+    const uint8_t *data = payload + PAYLOAD_HEADER_SIZE;
+    uint16_t length = payload_length - PAYLOAD_HEADER_SIZE;
+    time_t fetched_at = 0;
+    if (flags & SYNC_FLAG_COMPLETE)
+    {
+        if (length < SYNC_COMPLETE_SIZE)
+            return;
 
-            set_region_score(region, time, score);
+        fetched_at = (time_t)(((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | (data[2] << 8) | data[3]);
+        data += SYNC_COMPLETE_SIZE;
+        length -= SYNC_COMPLETE_SIZE;
+    }
+    bool already_loaded = is_data_loaded();
+    bool was_stale = is_data_stale();
+    bool changed = false;
+    switch (op)
+    {
+    case OP_TIMELINE:
+        changed = handle_timeline(data, length);
+        break;
+    default:
+        return;
+    }
+
+    set_data_sequence(sequence);
+    if (flags & SYNC_FLAG_COMPLETE)
+        set_data_synced(fetched_at);
+    save_region_scores();
+    trace_mark(TRACE_PAYLOAD_APPLIED);
 
-            if (region == get_current_region())
-            {
-                update_score(time);
-            }
-        }
+    if (changed)
+        memory_stats_log("score_update");
+
+    if (!already_loaded && is_data_loaded())
+    {
+        show_main_window();
+    }
+    else if (changed || (was_stale && !is_data_stale()))
+    {
+        // Only changed scores repaint, but the stale marker on the date also clears
+        update_all();
+    }
+}
+
+static void transfer_complete_handler(const uint8_t *data, uint16_t length)
+{
+    if (length < 1)
+        return;
+
+    handle_payload((Opcode)data[0], data + 1, length - 1);
+}
+
+static void inbox_received_callback(DictionaryIterator *iter, void *context)
+{
+    Tuple *op_tuple = dict_find(iter, MESSAGE_KEY_op);
+    if (!op_tuple)
+        return;
+
+    const Opcode op = (Opcode)op_tuple->value->int32;
+    if (op == OP_READY)
+    {
+        trace_mark(TRACE_READY_RECEIVED);
+#ifdef TRACE
+        // One already on its way was sent before the phone was ready, the one answering it is still to come
+        s_ready_update_pending = !(s_outbox_in_flight && s_outbox[0] == OP_UPDATE_ALL);
+#endif
+        send_update_all_message();
+        return;
+    }
+
+    Tuple *payload_tuple = dict_find(iter, MESSAGE_KEY_payload);
+    if (!payload_tuple || payload_tuple->length < 1)
+        return;
+
+    const uint8_t *payload = payload_tuple->value->data;
+    if (op != OP_CHUNK)
+    {
+        handle_payload(op, payload, payload_tuple->length);
+        return;
+    }
+
+    if (payload[0] != PROTOCOL_VERSION)
+    {
+        APP_LOG(APP_LOG_LEVEL_ERROR, "[AppMessage] Unsupported protocol version: %d", payload[0]);
         return;
     }
 
-    if (strcmp(type_tuple->value->cstring, "new_scores") == 0)
+    // A lost chunk loses the update it belonged to
+    if (!transfer_receive_chunk(payload + 1, payload_tuple->length - 1))
     {
-        Tuple *north_morning = dict_find(iter, MESSAGE_KEY_northMorning);
-        Tuple *north_afternoon = dict_find(iter, MESSAGE_KEY_northAfternoon);
-        Tuple *south_morning = dict_find(iter, MESSAGE_KEY_southMorning);
-        Tuple *south_afternoon = dict_find(iter, MESSAGE_KEY_southAfternoon);
+        queue_message(OP_RESYNC);
+    }
+}
 
-        if (north_morning && north_afternoon && south_morning && south_afternoon)
-        {
-            bool already_loaded = get_data_loaded_progress() == 4;
+static void send_next_message(void);
 
-            set_region_score(REGION_NORTH, TIME_MORNING, (int8_t)north_morning->value->int32);
-            set_region_score(REGION_NORTH, TIME_AFTERNOON, (int8_t)north_afternoon->value->int32);
-            set_region_score(REGION_SOUTH, TIME_MORNING, (int8_t)south_morning->value->int32);
-            set_region_score(REGION_SOUTH, TIME_AFTERNOON, (int8_t)south_afternoon->value->int32);
+static void retry_timer_callback(void *context)
+{
+    s_retry_timer = NULL;
+    send_next_message();
+}
+
+static void reset_retries(void)
+{
+    s_retry_ms = RETRY_INITIAL_MS;
+    s_retry_attempts = 0;
+}
 
-            if (!already_loaded && get_data_loaded_progress() == 4)
-            {
-                show_main_window();
-            }
-            else
-            {
-                update_all();
-            }
-        }
+// Tries the head of the queue again later, waiting twice as long after each failure up to a cap. Without the phone
+// or after a few attempts the queue is dropped, the scheduler asks again on reconnect or at its next refresh.
+static void schedule_retry(AppMessageResult reason)
+{
+    if (s_retry_timer)
+        return;
+
+    if (reason == APP_MSG_NOT_CONNECTED || s_retry_attempts >= RETRY_MAX_ATTEMPTS)
+    {
+        APP_LOG(APP_LOG_LEVEL_WARNING, "[AppMessage] Dropping %d queued messages after %d retries", s_outbox_count,
+                s_retry_attempts);
+        s_outbox_count = 0;
+        reset_retries();
+        return;
     }
+
+    s_retry_attempts++;
+    s_retry_timer = app_timer_register(s_retry_ms, retry_timer_callback, NULL);
+    s_retry_ms = (s_retry_ms * 2 < RETRY_MAX_MS) ? s_retry_ms * 2 : RETRY_MAX_MS;
 }
 
-bool send_update_all_message(void)
+static void send_next_message(void)
 {
+    if (s_outbox_in_flight || s_retry_timer || s_outbox_count == 0)
+        return;
+
     DictionaryIterator *iter;
     AppMessageResult appMessageResult = app_message_outbox_begin(&iter);
-
     if (appMessageResult != APP_MSG_OK)
     {
         APP_LOG(APP_LOG_LEVEL_ERROR, "[AppMessage] Outbox begin failed: %d", appMessageResult);
-        return false;
+        schedule_retry(appMessageResult);
+        return;
     }
 
-    DictionaryResult dictResult = dict_write_cstring(iter, MESSAGE_KEY_type, "update_all");
+    // Tells the phone what the watch already has, so it only sends what changed since
+    const uint16_t sequence = get_data_sequence();
+    const uint8_t header[PAYLOAD_HEADER_SIZE + 2] = {
+        PROTOCOL_VERSION,
+        sequence >> 8,
+        sequence & 0xFF,
+        (is_data_stale() ? SYNC_FLAG_STALE : 0) | (s_fetch_first ? SYNC_FLAG_FETCH_FIRST : 0),
+        // Lets the phone size chunks to what the inbox can take
+        INBOX_SIZE >> 8,
+        INBOX_SIZE & 0xFF,
+    };
+
+    DictionaryResult dictResult = dict_write_uint8(iter, MESSAGE_KEY_op, s_outbox[0]);
+    if (dictResult == DICT_OK)
+    {
+        dictResult = dict_write_data(iter, MESSAGE_KEY_payload, header, sizeof(header));
+    }
     if (dictResult != DICT_OK)
     {
         APP_LOG(APP_LOG_LEVEL_ERROR, "[AppMessage] Write failed: %d", dictResult);
-        return false;
+        schedule_retry(APP_MSG_INTERNAL_ERROR);
+        return;
     }
 
     appMessageResult = app_message_outbox_send();
     if (appMessageResult != APP_MSG_OK)
     {
         APP_LOG(APP_LOG_LEVEL_ERROR, "[AppMessage] Outbox send failed: %d", appMessageResult);
+        schedule_retry(appMessageResult);
+        return;
+    }
+
+    s_outbox_in_flight = true;
+#ifdef TRACE
+    if (s_outbox[0] == OP_UPDATE_ALL)
+    {
+        trace_mark(s_ready_update_pending ? TRACE_READY_UPDATE_SENT : TRACE_UPDATE_SENT);
+        s_ready_update_pending = false;
+    }
+#endif
+}
+
+static void outbox_sent_callback(DictionaryIterator *iter, void *context)
+{
+    s_outbox_in_flight = false;
+    reset_retries();
+
+    if (s_outbox_count == 0)
+        return;
+
+    s_outbox_count--;
+    memmove(s_outbox, s_outbox + 1, s_outbox_count * sizeof(s_outbox[0]));
+    send_next_message();
+}
+
+static void outbox_failed_callback(DictionaryIterator *iter, AppMessageResult reason, void *context)
+{
+    APP_LOG(APP_LOG_LEVEL_ERROR, "[AppMessage] Outbox failed: %d", reason);
+    s_outbox_in_flight = false;
+    schedule_retry(reason);
+}
+
+// Queues a message for the phone unless the same one is already waiting or being sent
+static bool queue_message(Opcode op)
+{
+    for (uint8_t i = 0; i < s_outbox_count; i++)
+    {
+        if (s_outbox[i] == op)
+            return true;
+    }
+
+    if (s_outbox_count == OUTBOX_QUEUE_SIZE)
+    {
+        APP_LOG(APP_LOG_LEVEL_ERROR, "[AppMessage] Outbox queue full, dropping: %d", op);
         return false;
     }
 
+    s_outbox[s_outbox_count++] = op;
+    send_next_message();
     return true;
 }
 
-void communication_init(void)
+bool send_update_all_message(void)
+{
+    return queue_message(OP_UPDATE_ALL);
+}
+
+// A launch that closes after its first sync asks for a fetch first, or it would close on the cached scores
+void communication_init(bool fetch_first)
 {
-    events_app_message_request_inbox_size(128);
-    events_app_message_request_outbox_size(128);
-    events_app_message_register_inbox_received(inbox_received_callback, NULL);
+    s_fetch_first = fetch_first;
+    events_app_message_request_inbox_size(INBOX_SIZE);
+    events_app_message_request_outbox_size(OUTBOX_SIZE);
+    transfer_init(transfer_complete_handler);
+    s_inbox_received_handle = events_app_message_register_inbox_received(inbox_received_callback, NULL);
+    s_outbox_sent_handle = events_app_message_register_outbox_sent(outbox_sent_callback, NULL);
+    s_outbox_failed_handle = events_app_message_register_outbox_failed(outbox_failed_callback, NULL);
     events_app_message_open();
 }
 
 void communication_deinit(void)
 {
+    transfer_deinit();
+    if (s_retry_timer)
+    {
+        app_timer_cancel(s_retry_timer);
+        s_retry_timer = NULL;
+    }
+    events_app_message_unsubscribe(s_inbox_received_handle);
+    events_app_message_unsubscribe(s_outbox_sent_handle);
+    events_app_message_unsubscribe(s_outbox_failed_handle);
 }
@@ -2,6 +2,6 @@
 
 #include <pebble.h>
 
-void communication_init(void);
+void communication_init(bool fetch_first);
 void communication_deinit(void);
 bool send_update_all_message(void);
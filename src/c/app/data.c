@@ -1,64 +1,355 @@
 #include "data.h"
+#include "persist.h"
 
-static RegionScores s_region_scores[2] = {
-    {.morning = -1, .afternoon = -1}, // North
-    {.morning = -1, .afternoon = -1}  // South
+#define HOUR_UNKNOWN 0xF
+// Every region's timeline, a single persist value at one day per region
+#define TIMELINE_MEMORY_BUDGET 256
+#define LOADED_BITS (REGION_COUNT * TIME_PERIOD_COUNT)
+#define LOADED_WORDS ((LOADED_BITS + 31) / 32)
+
+static RegionTimeline s_timelines[REGION_COUNT];
+static int32_t s_base_day;
+// Sequence number of the last update applied from the phone, 0 when the timelines did not come from a sync
+static uint16_t s_sequence;
+// When the phone fetched the forecast behind the timelines, as it reported at the end of the last sync
+static time_t s_fetched_at;
+
+_Static_assert(sizeof(s_timelines) <= TIMELINE_MEMORY_BUDGET, "Region timelines exceed their memory budget");
+_Static_assert(REGION_COUNT <= UINT8_MAX, "Region ids must fit in a byte");
+
+static const char *const s_region_names[REGION_COUNT] = {
+#define REGION_NAME(id, name) name,
+    REGION_TABLE(REGION_NAME)
+#undef REGION_NAME
 };
 
+// One bit per region and time period that has a score for today, refreshed when the timelines change
+static uint32_t s_loaded[LOADED_WORDS];
+static int32_t s_loaded_day;
+
 static Region s_current_region = REGION_NORTH;
+static bool s_stale = false;
+static bool s_synced = false;
+
+// Days since the epoch in Japan, where the forecast periods are defined
+static int32_t get_forecast_day(time_t time)
+{
+    return (int32_t)((time + JST_OFFSET_SECONDS) / SECONDS_PER_DAY);
+}
+
+static int32_t get_today(void)
+{
+    return get_forecast_day(time(NULL));
+}
+
+static void clear_timelines(void)
+{
+    memset(s_timelines, (HOUR_UNKNOWN << 4) | HOUR_UNKNOWN, sizeof(s_timelines));
+}
+
+// Moves the timelines so day 0 is today, dropping days that have passed. The phone's record of what the watch holds
+// no longer matches, so the sequence goes back to 0 and the next sync starts over.
+static void align_timelines(int32_t today)
+{
+    int32_t shift = today - s_base_day;
+    if (shift == 0)
+        return;
+
+    if (shift < 0 || shift >= TIMELINE_DAYS)
+    {
+        clear_timelines();
+    }
+    else
+    {
+        const size_t day_bytes = HOURS_PER_DAY / 2;
+        const size_t kept_bytes = (TIMELINE_DAYS - shift) * day_bytes;
+        for (size_t region = 0; region < REGION_COUNT; region++)
+        {
+            uint8_t *hours = s_timelines[region].hours;
+            memmove(hours, hours + shift * day_bytes, kept_bytes);
+            memset(hours + kept_bytes, (HOUR_UNKNOWN << 4) | HOUR_UNKNOWN, sizeof(s_timelines[region].hours) - kept_bytes);
+        }
+    }
+    s_base_day = today;
+    s_sequence = 0;
+}
+
+static uint8_t get_today_index(void)
+{
+    int32_t index = get_today() - s_base_day;
+    return (index < 0 || index >= TIMELINE_DAYS) ? TIMELINE_DAYS : (uint8_t)index;
+}
 
 Region get_current_region(void)
 {
     return s_current_region;
 }
 
-int8_t get_current_region_score(TimePeriod time)
+const char *get_region_name(Region region)
+{
+    return region < REGION_COUNT ? s_region_names[region] : "";
+}
+
+int8_t get_hourly_score(Region region, uint8_t day, uint8_t hour)
+{
+    if (region >= REGION_COUNT || day >= TIMELINE_DAYS || hour >= HOURS_PER_DAY)
+        return -1;
+
+    const size_t index = day * HOURS_PER_DAY + hour;
+    const uint8_t packed = s_timelines[region].hours[index / 2];
+    const uint8_t score = (index % 2) ? (packed >> 4) : (packed & 0xF);
+    return score == HOUR_UNKNOWN ? -1 : (int8_t)score;
+}
+
+static bool set_hourly_score(Region region, uint8_t day, uint8_t hour, int8_t score)
+{
+    if (region >= REGION_COUNT || day >= TIMELINE_DAYS || hour >= HOURS_PER_DAY)
+        return false;
+
+    const size_t index = day * HOURS_PER_DAY + hour;
+    const uint8_t value = (score < 0 || score > 10) ? HOUR_UNKNOWN : (uint8_t)score;
+    uint8_t *packed = &s_timelines[region].hours[index / 2];
+    const uint8_t previous = *packed;
+    if (index % 2)
+        *packed = (*packed & 0x0F) | (value << 4);
+    else
+        *packed = (*packed & 0xF0) | value;
+    return *packed != previous;
+}
+
+// Period score derived from the hourly scores: the rounded mean of the hours that have data
+int8_t get_region_score(Region region, uint8_t day, TimePeriod time)
 {
-    if (time == TIME_MORNING)
+    const uint8_t start_hour = (time == TIME_MORNING) ? MORNING_START_HOUR : AFTERNOON_START_HOUR;
+    int16_t total = 0;
+    int16_t count = 0;
+    for (uint8_t hour = start_hour; hour < start_hour + PERIOD_HOURS; hour++)
     {
-        return s_region_scores[s_current_region].morning;
+        int8_t score = get_hourly_score(region, day, hour);
+        if (score >= 0)
+        {
+            total += score;
+            count++;
+        }
     }
-    else
+    return count ? (int8_t)((total + count / 2) / count) : -1;
+}
+
+static void update_loaded_bits(Region region)
+{
+    const uint8_t today = get_today_index();
+    for (uint8_t time = 0; time < TIME_PERIOD_COUNT; time++)
     {
-        return s_region_scores[s_current_region].afternoon;
+        const uint16_t bit = region * TIME_PERIOD_COUNT + time;
+        if (get_region_score(region, today, (TimePeriod)time) != -1)
+            s_loaded[bit / 32] |= 1u << (bit % 32);
+        else
+            s_loaded[bit / 32] &= ~(1u << (bit % 32));
     }
 }
 
-void set_region_score(Region region, TimePeriod time, int8_t score)
+static void update_loaded(void)
 {
-    if (time == TIME_MORNING)
+    for (uint16_t region = 0; region < REGION_COUNT; region++)
     {
-        s_region_scores[region].morning = score;
+        update_loaded_bits((Region)region);
     }
-    else
+    s_loaded_day = get_today();
+}
+
+// The bits describe today, so they are rebuilt once the day rolls over
+static void ensure_loaded_current(void)
+{
+    if (s_loaded_day != get_today())
+        update_loaded();
+}
+
+// Stores consecutive hourly scores for a day counted from today, one score per byte, returning whether any changed
+bool set_hourly_scores(Region region, uint8_t day, uint8_t start_hour, const uint8_t *scores, uint16_t count)
+{
+    if (region >= REGION_COUNT)
+        return false;
+
+    align_timelines(get_today());
+    ensure_loaded_current();
+
+    bool changed = false;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        changed |= set_hourly_score(region, day, start_hour + i, (int8_t)scores[i]);
+    }
+    update_loaded_bits(region);
+    return changed;
+}
+
+int8_t get_current_region_score(TimePeriod time)
+{
+    return get_region_score(s_current_region, get_today_index(), time);
+}
+
+// Stores a period score for today as that score for every hour of the period, returning whether any hour changed
+bool set_region_score(Region region, TimePeriod time, int8_t score)
+{
+    if (region >= REGION_COUNT)
+        return false;
+
+    align_timelines(get_today());
+    ensure_loaded_current();
+
+    const uint8_t start_hour = (time == TIME_MORNING) ? MORNING_START_HOUR : AFTERNOON_START_HOUR;
+    bool changed = false;
+    for (uint8_t hour = start_hour; hour < start_hour + PERIOD_HOURS; hour++)
     {
-        s_region_scores[region].afternoon = score;
+        changed |= set_hourly_score(region, 0, hour, score);
     }
+    update_loaded_bits(region);
+    return changed;
 }
 
 void set_current_region(Region region)
 {
-    s_current_region = region;
+    if (region < REGION_COUNT)
+        s_current_region = region;
 }
 
+// Number of region and time period scores available for today
 int get_data_loaded_progress(void)
 {
+    ensure_loaded_current();
+
     int progress = 0;
-    if (s_region_scores[REGION_NORTH].morning != -1)
-        progress++;
-    if (s_region_scores[REGION_NORTH].afternoon != -1)
-        progress++;
-    if (s_region_scores[REGION_SOUTH].morning != -1)
-        progress++;
-    if (s_region_scores[REGION_SOUTH].afternoon != -1)
-        progress++;
+    for (uint16_t word = 0; word < LOADED_WORDS; word++)
+    {
+        for (uint32_t bits = s_loaded[word]; bits; bits &= bits - 1)
+            progress++;
+    }
     return progress;
 }
 
+// Whether the current region has a score for today, enough to show the main window. Periods and regions without
+// one are shown as missing.
+bool is_data_loaded(void)
+{
+    ensure_loaded_current();
+
+    const uint16_t bit = s_current_region * TIME_PERIOD_COUNT;
+    const uint32_t mask = ((1u << TIME_PERIOD_COUNT) - 1) << (bit % 32);
+    return (s_loaded[bit / 32] & mask) != 0;
+}
+
+// Whether every region has both period scores for today
+bool is_data_complete(void)
+{
+    return get_data_loaded_progress() == LOADED_BITS;
+}
+
+bool is_data_stale(void)
+{
+    return s_stale;
+}
+
+// Read for every update request and payload, so the first one after midnight already starts over
+uint16_t get_data_sequence(void)
+{
+    align_timelines(get_today());
+    return s_sequence;
+}
+
+void set_data_sequence(uint16_t sequence)
+{
+    s_sequence = sequence;
+}
+
+// Restored scores count as current again only once the phone has finished a sync, not after its first message
+void set_data_synced(time_t fetched_at)
+{
+    s_fetched_at = fetched_at;
+    s_stale = false;
+    s_synced = true;
+}
+
+// Whether a sync with the phone has completed since the app started
+bool is_data_synced(void)
+{
+    return s_synced;
+}
+
+time_t get_data_fetched_at(void)
+{
+    return s_fetched_at;
+}
+
+void save_region_scores(void)
+{
+    PersistedScores persisted = {
+        .version = PERSIST_SCORES_VERSION,
+        .region_count = REGION_COUNT,
+        .sequence = s_sequence,
+        .base_day = s_base_day,
+        .fetched_at = (int32_t)s_fetched_at,
+    };
+
+    const uint8_t *bytes = (const uint8_t *)s_timelines;
+    for (size_t offset = 0, key = PERSIST_KEY_TIMELINES; offset < sizeof(s_timelines);
+         offset += PERSIST_DATA_MAX_LENGTH, key++)
+    {
+        const size_t length = sizeof(s_timelines) - offset;
+        int result = persist_write_data(key, bytes + offset,
+                                        length < PERSIST_DATA_MAX_LENGTH ? length : PERSIST_DATA_MAX_LENGTH);
+        if (result < 0)
+        {
+            APP_LOG(APP_LOG_LEVEL_ERROR, "[Data] Persist write failed: %d", result);
+            return;
+        }
+    }
+
+    // Written last, so a partial write is never read back as a complete set of timelines
+    int result = persist_write_data(PERSIST_KEY_SCORES, &persisted, sizeof(persisted));
+    if (result < 0)
+    {
+        APP_LOG(APP_LOG_LEVEL_ERROR, "[Data] Persist write failed: %d", result);
+    }
+}
+
+static void load_region_scores(void)
+{
+    PersistedScores persisted;
+    if (persist_read_data(PERSIST_KEY_SCORES, &persisted, sizeof(persisted)) != sizeof(persisted))
+        return;
+
+    // A different region table changes the meaning of every region id
+    if (persisted.version != PERSIST_SCORES_VERSION || persisted.region_count != REGION_COUNT)
+        return;
+
+    uint8_t *bytes = (uint8_t *)s_timelines;
+    for (size_t offset = 0, key = PERSIST_KEY_TIMELINES; offset < sizeof(s_timelines);
+         offset += PERSIST_DATA_MAX_LENGTH, key++)
+    {
+        const size_t remaining = sizeof(s_timelines) - offset;
+        const int length = remaining < PERSIST_DATA_MAX_LENGTH ? (int)remaining : PERSIST_DATA_MAX_LENGTH;
+        if (persist_read_data(key, bytes + offset, length) != length)
+        {
+            clear_timelines();
+            return;
+        }
+    }
+    s_base_day = persisted.base_day;
+    s_sequence = persisted.sequence;
+    s_fetched_at = persisted.fetched_at;
+
+    // Days that have passed are dropped, so only a forecast covering today counts as loaded
+    align_timelines(get_today());
+    s_stale = true;
+}
+
 void data_init(void)
 {
+    clear_timelines();
+    s_base_day = get_today();
+    load_region_scores();
+    update_loaded();
 }
 
 void data_deinit(void)
 {
-}
\ No newline at end of file
+}
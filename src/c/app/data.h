@@ -1,29 +1,53 @@
 #pragma once
 
 #include <pebble.h>
+#include "persist.h"
+#include "regions.auto.h"
 
+// Days of hourly scores kept per region, starting with today. The phone only forecasts today, see getUrl in
+// src/pkjs/index.js, so more days would only hold unknown hours in RAM and in storage.
+#define TIMELINE_DAYS 1
+#define HOURS_PER_DAY 24
+
+// Region ids are positions in the table shared with the phone, see src/pkjs/regions.json
 typedef enum
 {
-    REGION_NORTH = 0,
-    REGION_SOUTH = 1
+#define REGION_ENUM(id, name) REGION_##id,
+    REGION_TABLE(REGION_ENUM)
+#undef REGION_ENUM
+    REGION_COUNT
 } Region;
 
 typedef enum
 {
     TIME_MORNING = 0,
-    TIME_AFTERNOON = 1
+    TIME_AFTERNOON = 1,
+    TIME_PERIOD_COUNT
 } TimePeriod;
 
+// Hourly scores (0-10) packed two per byte, 0xF marks an hour without data
 typedef struct
 {
-    int8_t morning;
-    int8_t afternoon;
-} RegionScores;
+    uint8_t hours[TIMELINE_DAYS * HOURS_PER_DAY / 2];
+} RegionTimeline;
 
 void data_init(void);
 void data_deinit(void);
 Region get_current_region(void);
-void set_region_score(Region region, TimePeriod time, int8_t score);
+const char *get_region_name(Region region);
+int8_t get_hourly_score(Region region, uint8_t day, uint8_t hour);
+bool set_hourly_scores(Region region, uint8_t day, uint8_t start_hour, const uint8_t *scores, uint16_t count);
+int8_t get_region_score(Region region, uint8_t day, TimePeriod time);
+bool set_region_score(Region region, TimePeriod time, int8_t score);
 int8_t get_current_region_score(TimePeriod time);
 void set_current_region(Region region);
-int get_data_loaded_progress(void);
\ No newline at end of file
+int get_data_loaded_progress(void);
+bool is_data_loaded(void);
+bool is_data_complete(void);
+bool is_data_stale(void);
+uint16_t get_data_sequence(void);
+void set_data_sequence(uint16_t sequence);
+void set_data_synced(time_t fetched_at);
+time_t get_data_fetched_at(void);
+bool is_data_synced(void);
+void save_region_scores(void);
@@ -0,0 +1,53 @@
+#include "glance.h"
+#include "../utility/utility.h"
+#include "data.h"
+
+#define GLANCE_TEXT_SIZE 64
+
+#if PBL_API_EXISTS(app_glance_reload)
+// One word per bucket, the launcher shows the glance on a single line
+static const char *const s_bucket_words[SCORE_BUCKET_COUNT] = {"Not", "Barely", "Partly", "Visible"};
+
+static char s_glance_text[GLANCE_TEXT_SIZE];
+
+static const char *get_score_word(int8_t score)
+{
+    return score < 0 ? "--" : s_bucket_words[get_score_bucket(score)];
+}
+
+static void glance_reload_callback(AppGlanceReloadSession *session, size_t limit, void *context)
+{
+    if (limit < 1 || !is_data_loaded())
+        return;
+
+    const Region region = get_current_region();
+    snprintf(s_glance_text, sizeof(s_glance_text), "%s: AM %s / PM %s", get_region_name(region),
+             get_score_word(get_current_region_score(TIME_MORNING)),
+             get_score_word(get_current_region_score(TIME_AFTERNOON)));
+
+    // Today's scores mean nothing once the afternoon period is over
+    const time_t now = time(NULL);
+    const time_t day_start = now - (now + JST_OFFSET_SECONDS) % SECONDS_PER_DAY;
+    const AppGlanceSlice slice = {
+        .layout = {
+            .icon = APP_GLANCE_SLICE_DEFAULT_ICON,
+            .subtitle_template_string = s_glance_text,
+        },
+        .expiration_time = day_start + (AFTERNOON_START_HOUR + PERIOD_HOURS) * SECONDS_PER_HOUR,
+    };
+
+    const AppGlanceResult result = app_glance_add_slice(session, slice);
+    if (result != APP_GLANCE_RESULT_SUCCESS)
+    {
+        APP_LOG(APP_LOG_LEVEL_ERROR, "[Glance] Add slice failed: %d", result);
+    }
+}
+#endif
+
+// Shows the current region's scores in the launcher, so reading them does not need the app
+void glance_publish(void)
+{
+#if PBL_API_EXISTS(app_glance_reload)
+    app_glance_reload(glance_reload_callback, NULL);
+#endif
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <pebble.h>
+
+void glance_publish(void);
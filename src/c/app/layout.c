@@ -0,0 +1,88 @@
+#include "layout.h"
+
+#define LAYOUT_RECT(x, y, w, h) {{(x), (y)}, {(w), (h)}}
+#define LAYOUT_POINT(x, y) {(x), (y)}
+
+#ifdef PBL_ROUND
+#define BUBBLE_INSET PLATFORM_SCALE(ROUND_BUBBLE_INSET_BASE)
+#define BUBBLE_HEIGHT PLATFORM_SCALE(ROUND_BUBBLE_HEIGHT_BASE)
+#define SCORE_INSET (BUBBLE_INSET + PADDING)
+#define REGION_X ((SCREEN_WIDTH - REGION_BUBBLE_WIDTH) / 2)
+#define DATE_Y (SCREEN_HEIGHT - REGION_BUBBLE_HEIGHT - PADDING)
+#else
+#define BUBBLE_INSET PADDING
+#define BUBBLE_HEIGHT TIME_BUBBLE_HEIGHT
+#define SCORE_INSET (PADDING * 2)
+#define REGION_X (SCREEN_WIDTH - PADDING - REGION_BUBBLE_WIDTH)
+#define DATE_Y PADDING
+#endif
+
+#define MORNING_Y (PADDING * 2 + REGION_BUBBLE_HEIGHT)
+#define AFTERNOON_Y (MORNING_Y + BUBBLE_HEIGHT + PADDING)
+
+#define BUBBLE_RECT(y) LAYOUT_RECT(BUBBLE_INSET, (y), SCREEN_WIDTH - BUBBLE_INSET * 2, BUBBLE_HEIGHT)
+
+// Score bubble next to the image, shrunk vertically when the text fits on one line
+#define SCORE_RECT(bubble_y, single_line_padding_y)                                                                  \
+    LAYOUT_RECT(SCREEN_WIDTH / 2 + PADDING,                                                                          \
+                (bubble_y) + ((BUBBLE_HEIGHT / 2) - (SCORE_BUBBLE_HEIGHT / 2)) + (single_line_padding_y),            \
+                SCREEN_WIDTH / 2 - SCORE_INSET - 10, SCORE_BUBBLE_HEIGHT - ((single_line_padding_y) * 2))
+
+#ifdef PBL_ROUND
+#define MORNING_LABEL_RECT                                                                                           \
+    LAYOUT_RECT(BUBBLE_INSET + PADDING, MORNING_Y + PLATFORM_SCALE(ROUND_LABEL_OFFSET_BASE),                         \
+                SCREEN_WIDTH / 2 - PADDING * 3, REGION_BUBBLE_HEIGHT)
+#define AFTERNOON_LABEL_RECT                                                                                         \
+    LAYOUT_RECT(BUBBLE_INSET + PADDING, AFTERNOON_Y + PLATFORM_SCALE(ROUND_LABEL_OFFSET_BASE), SCREEN_WIDTH / 2,     \
+                REGION_BUBBLE_HEIGHT)
+#define IMAGE_X (BUBBLE_INSET + PLATFORM_SCALE(ROUND_IMAGE_OFFSET_BASE))
+#else
+// (PADDING * 5 + 1) / 2 rounds PADDING * 2.5 half up
+#define MORNING_LABEL_RECT                                                                                           \
+    LAYOUT_RECT((PADDING * 5 + 1) / 2, MORNING_Y + (REGION_BUBBLE_HEIGHT * 2), SCREEN_WIDTH / 2 - PADDING * 3,      \
+                REGION_BUBBLE_HEIGHT)
+#define AFTERNOON_LABEL_RECT                                                                                         \
+    LAYOUT_RECT(PADDING * 2, AFTERNOON_Y + (REGION_BUBBLE_HEIGHT * 2), SCREEN_WIDTH / 2, REGION_BUBBLE_HEIGHT)
+#define IMAGE_X PLATFORM_SCALE(RECT_IMAGE_X_BASE)
+#endif
+
+static const Layout s_layout = {
+    .region_bubble = LAYOUT_RECT(REGION_X, PADDING, REGION_BUBBLE_WIDTH, REGION_BUBBLE_HEIGHT),
+    .region_text = LAYOUT_RECT(REGION_X + 4, PADDING, REGION_BUBBLE_WIDTH - 8, REGION_BUBBLE_HEIGHT),
+    .date_text = LAYOUT_RECT(PADDING, DATE_Y, SCREEN_WIDTH - PADDING * 2, REGION_BUBBLE_HEIGHT),
+    .loading_text =
+        LAYOUT_RECT(0, SCREEN_HEIGHT / 2 + LOADING_TEXT_Y_PADDING, SCREEN_WIDTH, LOADING_TEXT_HEIGHT),
+    .time_bubble =
+        {
+            [TIME_MORNING] = BUBBLE_RECT(MORNING_Y),
+            [TIME_AFTERNOON] = BUBBLE_RECT(AFTERNOON_Y),
+        },
+    .time_label =
+        {
+            [TIME_MORNING] = MORNING_LABEL_RECT,
+            [TIME_AFTERNOON] = AFTERNOON_LABEL_RECT,
+        },
+    .score_bubble =
+        {
+            [TIME_MORNING] =
+                {
+                    [SCORE_LINES_ONE] = SCORE_RECT(MORNING_Y, PADDING),
+                    [SCORE_LINES_TWO] = SCORE_RECT(MORNING_Y, 0),
+                },
+            [TIME_AFTERNOON] =
+                {
+                    [SCORE_LINES_ONE] = SCORE_RECT(AFTERNOON_Y, PADDING),
+                    [SCORE_LINES_TWO] = SCORE_RECT(AFTERNOON_Y, 0),
+                },
+        },
+    .score_image =
+        {
+            [TIME_MORNING] = LAYOUT_POINT(IMAGE_X, MORNING_Y + PADDING),
+            [TIME_AFTERNOON] = LAYOUT_POINT(IMAGE_X, AFTERNOON_Y + PADDING),
+        },
+};
+
+const Layout *get_layout(void)
+{
+    return &s_layout;
+}
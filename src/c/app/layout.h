@@ -0,0 +1,88 @@
+#pragma once
+
+#include "data.h"
+#include <pebble.h>
+
+// Integer equivalent of ceil(x * 1.35) on emery so every dimension is a compile time constant
+#ifdef PBL_PLATFORM_EMERY
+#define PLATFORM_SCALE(x) ((int16_t)(((x) * 135 + 99) / 100))
+#else
+#define PLATFORM_SCALE(x) ((int16_t)(x))
+#endif
+
+// Base dimensions based on 144x168
+#define DRAWING_STROKE_BASE 3
+#define DRAWING_SIZE_BASE 30
+#define PADDING_BASE 6
+#define CORNER_RADIUS_MAIN_BASE 14
+#define CORNER_RADIUS_BUBBLE_BASE 8
+#define REGION_BUBBLE_WIDTH_BASE 54
+#define REGION_BUBBLE_HEIGHT_BASE 20
+#define SCORE_BUBBLE_WIDTH_BASE 48
+#define SCORE_BUBBLE_HEIGHT_BASE 34
+#define TIME_BUBBLE_HEIGHT_BASE 62
+#define LOADING_TEXT_Y_PADDING_BASE 50
+#define LOADING_TEXT_HEIGHT_BASE 30
+#define ROUND_BUBBLE_INSET_BASE 22
+#define ROUND_BUBBLE_HEIGHT_BASE 57
+#define ROUND_LABEL_OFFSET_BASE 36
+#define ROUND_IMAGE_OFFSET_BASE 15
+#define ROUND_IMAGE_SIZE_BASE 24
+#define RECT_IMAGE_X_BASE 24
+
+// Scaled dimensions
+#define DRAWING_STROKE PLATFORM_SCALE(DRAWING_STROKE_BASE)
+#define DRAWING_SIZE PLATFORM_SCALE(DRAWING_SIZE_BASE)
+#define PADDING PLATFORM_SCALE(PADDING_BASE)
+#define CORNER_RADIUS_MAIN PLATFORM_SCALE(CORNER_RADIUS_MAIN_BASE)
+#define CORNER_RADIUS_BUBBLE PLATFORM_SCALE(CORNER_RADIUS_BUBBLE_BASE)
+#define REGION_BUBBLE_WIDTH PLATFORM_SCALE(REGION_BUBBLE_WIDTH_BASE)
+#define REGION_BUBBLE_HEIGHT PLATFORM_SCALE(REGION_BUBBLE_HEIGHT_BASE)
+#define SCORE_BUBBLE_WIDTH PLATFORM_SCALE(SCORE_BUBBLE_WIDTH_BASE)
+#define SCORE_BUBBLE_HEIGHT PLATFORM_SCALE(SCORE_BUBBLE_HEIGHT_BASE)
+#define TIME_BUBBLE_HEIGHT PLATFORM_SCALE(TIME_BUBBLE_HEIGHT_BASE)
+#define LOADING_TEXT_Y_PADDING PLATFORM_SCALE(LOADING_TEXT_Y_PADDING_BASE)
+#define LOADING_TEXT_HEIGHT PLATFORM_SCALE(LOADING_TEXT_HEIGHT_BASE)
+
+// Screen size, equal to the bounds of a full screen window
+#define SCREEN_WIDTH PBL_DISPLAY_WIDTH
+#define SCREEN_HEIGHT PBL_DISPLAY_HEIGHT
+
+// Score image size
+#ifdef PBL_ROUND
+#define SCORE_IMAGE_SIZE PLATFORM_SCALE(ROUND_IMAGE_SIZE_BASE)
+#else
+#define SCORE_IMAGE_SIZE DRAWING_SIZE
+#endif
+
+// Font selection based on platform
+#ifdef PBL_PLATFORM_EMERY
+#define LABEL_FONT FONT_KEY_GOTHIC_18_BOLD
+#define DATE_FONT FONT_KEY_GOTHIC_18_BOLD
+#define LOADING_FONT FONT_KEY_GOTHIC_24_BOLD
+#else
+#define LABEL_FONT FONT_KEY_GOTHIC_14_BOLD
+#define DATE_FONT FONT_KEY_GOTHIC_14_BOLD
+#define LOADING_FONT FONT_KEY_GOTHIC_18_BOLD
+#endif
+
+typedef enum
+{
+    SCORE_LINES_ONE = 0,
+    SCORE_LINES_TWO = 1
+} ScoreLines;
+
+// Every position on the main and loading windows, resolved at compile time
+typedef struct
+{
+    GRect region_bubble;
+    GRect region_text;
+    GRect date_text;
+    GRect loading_text;
+    GRect time_bubble[2];
+    GRect time_label[2];
+    GRect score_bubble[2][2];
+    GPoint score_image[2];
+} Layout;
+
+const Layout *get_layout(void);
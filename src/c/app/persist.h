@@ -0,0 +1,51 @@
+#pragma once
+
+// Only plain types, the worker builds against pebble_worker.h instead of pebble.h
+#include <stdbool.h>
+#include <stdint.h>
+
+// Forecast periods and days are defined in Japan time
+#define MORNING_START_HOUR 6
+#define AFTERNOON_START_HOUR 12
+#define PERIOD_HOURS 6
+#define JST_OFFSET_SECONDS (9 * 3600)
+#define SECONDS_PER_HOUR 3600
+#define SECONDS_PER_DAY (24 * 3600)
+
+// Quiet launches, by a wakeup or the worker, refresh this long before each viewing period starts
+#define QUIET_LAUNCH_LEAD_S (15 * 60)
+// Scores the phone fetched more recently than this are left alone, as is the app after a recent quiet launch
+#define MIN_SCORE_AGE_S (3 * SECONDS_PER_HOUR)
+
+// Persistent storage is shared with the background worker in worker_src, so both lay it out from here
+#define PERSIST_KEY_SCORES 1
+// Timelines are split across consecutive keys from here on, one persist value holds at most 256 bytes
+#define PERSIST_KEY_TIMELINES 2
+#define PERSIST_KEY_WORKER 100
+#define PERSIST_SCORES_VERSION 6
+
+// Context for the timelines as last received from the phone, which are persisted separately
+typedef struct
+{
+    uint8_t version;
+    uint8_t region_count;
+    uint16_t sequence;
+    int32_t base_day;
+    // When the phone fetched the forecast behind the scores, 0 before the first completed sync
+    int32_t fetched_at;
+} PersistedScores;
+
+// Shared by the app and the worker, each updates only its own fields
+typedef struct
+{
+    // Last quiet launch, whichever of the worker or a wakeup made it
+    int32_t last_launch;
+    // The app asked the user to start the worker, which the system confirms with a dialog
+    bool launch_asked;
+} PersistedWorker;
+
+// Whether a quiet launch would bring anything new: the scores are old and no other quiet launch just tried
+static inline bool is_quiet_launch_due(int32_t fetched_at, int32_t last_launch, int32_t now)
+{
+    return fetched_at + MIN_SCORE_AGE_S <= now && last_launch + MIN_SCORE_AGE_S <= now;
+}
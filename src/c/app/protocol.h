@@ -0,0 +1,40 @@
+#pragma once
+
+// AppMessage protocol spoken with src/pkjs/index.js. Every message carries an opcode and, for data
+// messages, one byte array payload starting with a header of PAYLOAD_HEADER_SIZE bytes.
+#define PROTOCOL_VERSION 5
+
+typedef enum
+{
+    // Phone to watch: PebbleKit JS is up, no payload
+    OP_READY = 1,
+    // Watch to phone: fetch every region and send what changed since the sequence number in the header, which is
+    // followed by the big endian inbox size of the watch
+    OP_UPDATE_ALL = 2,
+    // 3 carried period scores up to version 4, the watch now derives them from the timelines
+    // Phone to watch: timeline records of region, day, start hour and hour count, then one score byte per hour
+    OP_TIMELINE = 4,
+    // Watch to phone: an update was missed, send everything again
+    OP_RESYNC = 5,
+    // Phone to watch: part of a payload too large for the inbox, which once reassembled starts with its opcode
+    OP_CHUNK = 6
+} Opcode;
+
+// Header: protocol version, big endian sequence number and flags
+#define PAYLOAD_HEADER_SIZE 4
+
+// Phone to watch: the first message of a full resync, applied whatever sequence number came before
+#define SYNC_FLAG_RESET 0x1
+// Watch to phone: the scores on the watch were restored from storage and need confirming
+#define SYNC_FLAG_STALE 0x2
+// Phone to watch: the last message of a sync, once applied the watch holds everything the phone has. Its header
+// is followed by SYNC_COMPLETE_SIZE bytes of the big endian time the forecast was fetched, in seconds since the epoch
+#define SYNC_FLAG_COMPLETE 0x4
+#define SYNC_COMPLETE_SIZE 4
+// Watch to phone: the app closes after this sync, so fetch first instead of sending cached scores ahead of a fetch
+#define SYNC_FLAG_FETCH_FIRST 0x8
+
+#define TIMELINE_HEADER_SIZE 4
+
+// Chunk header after the protocol version: transfer id, then big endian chunk index, chunk count and total length
+#define CHUNK_HEADER_SIZE 7
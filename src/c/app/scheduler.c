@@ -0,0 +1,208 @@
+#include "scheduler.h"
+#include "communication.h"
+#include "data.h"
+#include "ui.h"
+#include <pebble-events/pebble-events.h>
+
+// An hour before the morning window, so the first forecast of the day is on the watch when it opens
+#define FIRST_REFRESH_HOUR (MORNING_START_HOUR - 1)
+#define LAST_REFRESH_HOUR (AFTERNOON_START_HOUR + PERIOD_HOURS)
+#define REFRESH_INTERVAL_S SECONDS_PER_HOUR
+// Missing or unconfirmed scores are asked for again sooner than a routine refresh
+#define RETRY_INTERVAL_S (15 * 60)
+#define LOW_BATTERY_PERCENT 20
+#define CRITICAL_BATTERY_PERCENT 10
+// The system refuses wakeups within a minute of another app's, so a taken slot moves earlier a minute at a time
+#define WAKEUP_ATTEMPTS 5
+
+static time_t s_last_refresh;
+static bool s_worker_running;
+static AppTimer *s_refresh_timer;
+
+static EventHandle s_tick_handle;
+static EventHandle s_connection_handle;
+static EventHandle s_battery_handle;
+
+static void schedule_refresh(void);
+
+// Refreshes get further apart as the battery runs down, unless it is charging. Missing or unconfirmed scores are
+// asked for again sooner than a routine refresh, but slow down the same way.
+static time_t get_refresh_interval(void)
+{
+    const time_t interval = (!is_data_complete() || is_data_stale()) ? RETRY_INTERVAL_S : REFRESH_INTERVAL_S;
+    BatteryChargeState charge = battery_state_service_peek();
+    if (charge.is_charging || charge.is_plugged)
+        return interval;
+    if (charge.charge_percent <= CRITICAL_BATTERY_PERCENT)
+        return interval * 4;
+    if (charge.charge_percent <= LOW_BATTERY_PERCENT)
+        return interval * 2;
+    return interval;
+}
+
+static time_t get_next_refresh(time_t now)
+{
+    const time_t day_start = now - (now + JST_OFFSET_SECONDS) % SECONDS_PER_DAY;
+    const time_t first_refresh = day_start + FIRST_REFRESH_HOUR * SECONDS_PER_HOUR;
+    const time_t last_refresh = day_start + LAST_REFRESH_HOUR * SECONDS_PER_HOUR;
+
+    // Once the afternoon period has ended nothing shown can change until tomorrow's forecast, retries included
+    time_t next = s_last_refresh + get_refresh_interval();
+    if (next < first_refresh)
+        next = first_refresh;
+    if (next >= last_refresh)
+        next = first_refresh + SECONDS_PER_DAY;
+    return next;
+}
+
+static void refresh(void)
+{
+    s_last_refresh = time(NULL);
+    send_update_all_message();
+}
+
+static void refresh_timer_callback(void *context)
+{
+    s_refresh_timer = NULL;
+    schedule_refresh();
+}
+
+// Refreshes now when one is due, otherwise sets a timer for the next one
+static void schedule_refresh(void)
+{
+    if (s_refresh_timer)
+    {
+        app_timer_cancel(s_refresh_timer);
+        s_refresh_timer = NULL;
+    }
+
+    // Nothing can reach the phone while disconnected, reconnecting refreshes straight away
+    if (!connection_service_peek_pebble_app_connection())
+        return;
+
+    const time_t now = time(NULL);
+    time_t next = get_next_refresh(now);
+    if (next <= now)
+    {
+        refresh();
+        next = get_next_refresh(now);
+    }
+    s_refresh_timer = app_timer_register((uint32_t)(next - now) * 1000, refresh_timer_callback, NULL);
+}
+
+// Registers a wakeup at the next time of day the slot comes around, in Japan time
+static void schedule_wakeup(time_t now, int hour, int32_t cookie)
+{
+    const time_t day_start = now - (now + JST_OFFSET_SECONDS) % SECONDS_PER_DAY;
+    time_t slot = day_start + hour * SECONDS_PER_HOUR - QUIET_LAUNCH_LEAD_S;
+    if (slot <= now)
+        slot += SECONDS_PER_DAY;
+
+    for (int attempt = 0; attempt < WAKEUP_ATTEMPTS; attempt++)
+    {
+        // A missed refresh is not worth a notification, the next launch refreshes anyway
+        const WakeupId id = wakeup_schedule(slot - attempt * 60, cookie, false);
+        if (id >= 0)
+            return;
+        if (id != E_RANGE)
+        {
+            APP_LOG(APP_LOG_LEVEL_ERROR, "[Scheduler] Wakeup schedule failed: %d", (int)id);
+            return;
+        }
+    }
+    APP_LOG(APP_LOG_LEVEL_ERROR, "[Scheduler] No wakeup slot free before %d:00", hour);
+}
+
+// Wakeups outlive the app, so the next one of each period is always registered when the app runs. A running
+// worker launches at the same slots itself, so then none are registered and the two never launch twice.
+static void schedule_wakeups(void)
+{
+    wakeup_cancel_all();
+    if (s_worker_running)
+        return;
+
+    const time_t now = time(NULL);
+    schedule_wakeup(now, MORNING_START_HOUR, TIME_MORNING);
+    schedule_wakeup(now, AFTERNOON_START_HOUR, TIME_AFTERNOON);
+}
+
+static void wakeup_handler(WakeupId id, int32_t cookie)
+{
+    // Fired while the app was already open, so it refreshes in place and registers the next slot
+    schedule_wakeups();
+    refresh();
+    schedule_refresh();
+}
+
+static void hour_tick_handler(struct tm *tick_time, TimeUnits units_changed)
+{
+    // Unchanged forecasts send nothing back, so the date rolls over here rather than on a reply
+    update_all();
+    schedule_refresh();
+}
+
+static void connection_handler(bool connected)
+{
+    if (connected)
+    {
+        refresh();
+    }
+    schedule_refresh();
+}
+
+static void battery_state_handler(BatteryChargeState charge)
+{
+    schedule_refresh();
+}
+
+// A wakeup launches the app whether or not that brings anything, so it goes by the same rules as the worker's
+// launches and claims the slot for both, see worker_src
+bool scheduler_claim_wakeup_launch(void)
+{
+#if PBL_API_EXISTS(quiet_time_is_active)
+    if (quiet_time_is_active())
+        return false;
+#endif
+
+    const time_t now = time(NULL);
+    PersistedWorker worker = {0};
+    persist_read_data(PERSIST_KEY_WORKER, &worker, sizeof(worker));
+    if (!is_quiet_launch_due((int32_t)get_data_fetched_at(), worker.last_launch, (int32_t)now))
+        return false;
+
+    worker.last_launch = (int32_t)now;
+    persist_write_data(PERSIST_KEY_WORKER, &worker, sizeof(worker));
+    return true;
+}
+
+// Also called on its own by a quiet launch that turns out to have nothing to do, which still has to register the
+// wakeups after the one that launched it
+void scheduler_register_wakeups(bool worker_running)
+{
+    s_worker_running = worker_running;
+    schedule_wakeups();
+}
+
+void scheduler_init(bool worker_running)
+{
+    s_tick_handle = events_tick_timer_service_subscribe(HOUR_UNIT, hour_tick_handler);
+    s_connection_handle = events_connection_service_subscribe((ConnectionHandlers){
+        .pebble_app_connection_handler = connection_handler,
+    });
+    s_battery_handle = events_battery_state_service_subscribe(battery_state_handler);
+    wakeup_service_subscribe(wakeup_handler);
+    scheduler_register_wakeups(worker_running);
+    schedule_refresh();
+}
+
+void scheduler_deinit(void)
+{
+    if (s_refresh_timer)
+    {
+        app_timer_cancel(s_refresh_timer);
+        s_refresh_timer = NULL;
+    }
+    events_tick_timer_service_unsubscribe(s_tick_handle);
+    events_connection_service_unsubscribe(s_connection_handle);
+    events_battery_state_service_unsubscribe(s_battery_handle);
+}
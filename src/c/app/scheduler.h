@@ -0,0 +1,8 @@
+#pragma once
+
+#include <pebble.h>
+
+void scheduler_init(bool worker_running);
+void scheduler_register_wakeups(bool worker_running);
+bool scheduler_claim_wakeup_launch(void);
+void scheduler_deinit(void);
@@ -0,0 +1,86 @@
+#include "transfer.h"
+#include "protocol.h"
+
+// Payloads larger than the inbox arrive in numbered chunks, copied into place as they come so each one can be
+// acknowledged straight away and the phone can keep the link busy
+static uint8_t s_buffer[TRANSFER_BUFFER_SIZE];
+static uint16_t s_received;
+static uint16_t s_total;
+static uint16_t s_next_index;
+static uint16_t s_chunk_count;
+static uint8_t s_transfer_id;
+static bool s_active;
+static TransferCompleteHandler s_handler;
+
+static uint16_t read_uint16(const uint8_t *data)
+{
+    return (data[0] << 8) | data[1];
+}
+
+void transfer_init(TransferCompleteHandler handler)
+{
+    s_handler = handler;
+    s_active = false;
+}
+
+void transfer_deinit(void)
+{
+    s_handler = NULL;
+    s_active = false;
+}
+
+// Takes a chunk without the protocol version, returning false when chunks went missing and the transfer was dropped
+bool transfer_receive_chunk(const uint8_t *chunk, uint16_t length)
+{
+    if (length < CHUNK_HEADER_SIZE)
+        return false;
+
+    const uint8_t transfer_id = chunk[0];
+    const uint16_t index = read_uint16(chunk + 1);
+    const uint16_t count = read_uint16(chunk + 3);
+    const uint16_t total = read_uint16(chunk + 5);
+    const uint8_t *data = chunk + CHUNK_HEADER_SIZE;
+    const uint16_t data_length = length - CHUNK_HEADER_SIZE;
+
+    // The first chunk starts a new transfer, replacing one that never finished
+    if (index == 0)
+    {
+        if (total > TRANSFER_BUFFER_SIZE)
+        {
+            APP_LOG(APP_LOG_LEVEL_ERROR, "[Transfer] Payload too large: %d", total);
+            s_active = false;
+            return false;
+        }
+        s_transfer_id = transfer_id;
+        s_total = total;
+        s_chunk_count = count;
+        s_received = 0;
+        s_next_index = 0;
+        s_active = true;
+    }
+
+    if (!s_active || transfer_id != s_transfer_id || index != s_next_index || s_received + data_length > s_total)
+    {
+        APP_LOG(APP_LOG_LEVEL_ERROR, "[Transfer] Unexpected chunk %d of transfer %d", index, transfer_id);
+        s_active = false;
+        return false;
+    }
+
+    memcpy(s_buffer + s_received, data, data_length);
+    s_received += data_length;
+    s_next_index++;
+
+    if (s_next_index == s_chunk_count)
+    {
+        s_active = false;
+        if (s_received != s_total)
+        {
+            APP_LOG(APP_LOG_LEVEL_ERROR, "[Transfer] Transfer %d ended short: %d of %d", transfer_id, s_received,
+                    s_total);
+            return false;
+        }
+        if (s_handler)
+            s_handler(s_buffer, s_total);
+    }
+    return true;
+}
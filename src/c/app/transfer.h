@@ -0,0 +1,12 @@
+#pragma once
+
+#include <pebble.h>
+
+// Largest payload the phone can stream to the watch in chunks
+#define TRANSFER_BUFFER_SIZE 1024
+
+typedef void (*TransferCompleteHandler)(const uint8_t *data, uint16_t length);
+
+void transfer_init(TransferCompleteHandler handler);
+void transfer_deinit(void);
+bool transfer_receive_chunk(const uint8_t *chunk, uint16_t length);
@@ -1,14 +1,23 @@
 #include "ui.h"
 #include "../utility/graphics.h"
+#include "../utility/memory_stats.h"
+#include "../utility/render_stats.h"
+#include "../utility/trace.h"
 #include "../utility/utility.h"
 #include "data.h"
-#include <math.h>
 
 static Window *s_loading_window;
 static BitmapLayer *s_loading_bitmap_layer;
 static GBitmap *s_loading_bitmap;
 static TextLayer *s_loading_text_layer;
 static Window *s_main_window;
+static Layer *s_canvas_layer;
+#ifdef UI_SINGLE_LAYER
+static GFont s_label_font;
+static GFont s_date_font;
+static GRect s_label_text_rects[2];
+static GRect s_score_text_rects[2][SCORE_BUCKET_COUNT];
+#else
 static TextLayer *s_date_layer;
 static TextLayer *s_region_layer;
 static TextLayer *s_morning_label_layer;
@@ -17,125 +26,253 @@ static TextLayer *s_morning_score_layer;
 static TextLayer *s_afternoon_score_layer;
 static Layer *s_morning_score_image_layer;
 static Layer *s_afternoon_score_image_layer;
-static Layer *s_canvas_layer;
 static Layer *s_data_layer;
+#endif
+static char s_date_buffer[16];
 
-static GRect calculate_bubble_rect(TimePeriod time, GRect bounds)
+// What the main window layers currently show, so updates only invalidate elements that changed
+static struct
 {
-#ifdef PBL_ROUND
-    const int16_t inset = PLATFORM_SCALE(22);
-    const int16_t bubble_height = PLATFORM_SCALE(57);
-    const int16_t base_y = PADDING * 2 + REGION_BUBBLE_HEIGHT;
-    const int16_t y = (time == TIME_MORNING) ? base_y : base_y + bubble_height + PADDING;
-    return GRect(inset, y, bounds.size.w - inset * 2, bubble_height);
+    bool valid;
+    int day;
+    bool stale;
+    Region region;
+    ScoreBucket buckets[2];
+    bool missing[2];
+} s_rendered;
+
+static ScoreLines get_score_lines(int8_t score)
+{
+    return get_score_bucket(score) == SCORE_BUCKET_VISIBLE ? SCORE_LINES_ONE : SCORE_LINES_TWO;
+}
+
+static void update_date()
+{
+    time_t now = time(NULL) + (9 * 3600);
+    struct tm *tick_time = localtime(&now);
+    bool stale = is_data_stale();
+    if (s_rendered.valid && s_rendered.day == tick_time->tm_yday && s_rendered.stale == stale)
+        return;
+
+    // Cached scores are shown straight away and marked until the refresh lands
+    strftime(s_date_buffer, sizeof(s_date_buffer), stale ? "%a %b %e..." : "%a %b %e", tick_time);
+#ifdef UI_SINGLE_LAYER
+    layer_mark_dirty(s_canvas_layer);
 #else
-    const int16_t base_y = PADDING * 2 + REGION_BUBBLE_HEIGHT;
-    const int16_t y = (time == TIME_MORNING) ? base_y : base_y + TIME_BUBBLE_HEIGHT + PADDING;
-    return GRect(PADDING, y, bounds.size.w - PADDING * 2, TIME_BUBBLE_HEIGHT);
+    text_layer_set_text(s_date_layer, s_date_buffer);
 #endif
+    s_rendered.day = tick_time->tm_yday;
+    s_rendered.stale = stale;
 }
 
-static GRect calculate_score_rect(TimePeriod time, GRect bounds, int8_t line_count)
+static void update_region()
 {
-    GRect bubble = calculate_bubble_rect(time, bounds);
-    int8_t single_line_padding_y = line_count == 1 ? PADDING : 0;
-    int16_t inset = PADDING * 2;
-    int16_t bubble_height = TIME_BUBBLE_HEIGHT;
-#ifdef PBL_ROUND
-    inset = PLATFORM_SCALE(22) + PADDING;
-    bubble_height = PLATFORM_SCALE(57);
+    Region region = get_current_region();
+    if (s_rendered.valid && s_rendered.region == region)
+        return;
+
+#ifdef UI_SINGLE_LAYER
+    layer_mark_dirty(s_canvas_layer);
+#else
+    text_layer_set_text(s_region_layer, get_region_name(region));
 #endif
-    return GRect(bounds.size.w / 2 + PADDING,
-                 bubble.origin.y + ((bubble_height / 2) - (SCORE_BUBBLE_HEIGHT / 2)) + single_line_padding_y,
-                 bounds.size.w / 2 - inset - 10, SCORE_BUBBLE_HEIGHT - (single_line_padding_y * 2));
+    s_rendered.region = region;
 }
 
-static void update_date()
+static void previous_region_click_handler(ClickRecognizerRef recognizer, void *context)
 {
-    time_t now = time(NULL) + (9 * 3600);
-    struct tm *tick_time = localtime(&now);
-    static char date_buffer[16];
-    strftime(date_buffer, sizeof(date_buffer), "%a %b %e", tick_time);
-    text_layer_set_text(s_date_layer, date_buffer);
+    trace_mark(TRACE_CLICK);
+    set_current_region((Region)((get_current_region() + REGION_COUNT - 1) % REGION_COUNT));
+    update_all();
 }
 
-static void update_region()
+static void next_region_click_handler(ClickRecognizerRef recognizer, void *context)
 {
-    text_layer_set_text(s_region_layer, get_current_region() == REGION_NORTH ? "North" : "South");
+    trace_mark(TRACE_CLICK);
+    set_current_region((Region)((get_current_region() + 1) % REGION_COUNT));
+    update_all();
 }
 
-static void region_toggle_click_handler(ClickRecognizerRef recognizer, void *context)
+#ifdef RENDER_STATS
+// Steps the current region through every morning/afternoon bucket pair so each frame cost gets checked
+static void render_stats_sweep_click_handler(ClickRecognizerRef recognizer, void *context)
 {
-    set_current_region((get_current_region() == REGION_NORTH) ? REGION_SOUTH : REGION_NORTH);
+    static const int8_t bucket_scores[SCORE_BUCKET_COUNT] = {0, 3, 6, 8};
+    static uint8_t step;
+
+    set_region_score(get_current_region(), TIME_MORNING, bucket_scores[step / SCORE_BUCKET_COUNT]);
+    set_region_score(get_current_region(), TIME_AFTERNOON, bucket_scores[step % SCORE_BUCKET_COUNT]);
+    step = (step + 1) % (SCORE_BUCKET_COUNT * SCORE_BUCKET_COUNT);
     update_all();
 }
+#endif
+
+#ifdef TRACE
+static void trace_dump_click_handler(ClickRecognizerRef recognizer, void *context)
+{
+    trace_dump();
+}
+#endif
 
 static void click_config_provider(void *context)
 {
-    window_single_click_subscribe(BUTTON_ID_UP, region_toggle_click_handler);
-    window_single_click_subscribe(BUTTON_ID_DOWN, region_toggle_click_handler);
+    window_single_click_subscribe(BUTTON_ID_UP, previous_region_click_handler);
+    window_single_click_subscribe(BUTTON_ID_DOWN, next_region_click_handler);
+#ifdef RENDER_STATS
+    window_single_click_subscribe(BUTTON_ID_SELECT, render_stats_sweep_click_handler);
+#endif
+#ifdef TRACE
+    window_long_click_subscribe(BUTTON_ID_SELECT, 0, trace_dump_click_handler, NULL);
+#endif
+}
+
+static void draw_time_score_image(GContext *ctx, Layer *layer, TimePeriod time)
+{
+    // The image sits on its time bubble, which the cached capture includes
+    const GColor background = time == TIME_MORNING ? TIME_MORNING_BUBBLE_COLOR : TIME_AFTERNOON_BUBBLE_COLOR;
+    graphics_context_set_stroke_width(ctx, DRAWING_STROKE);
+    graphics_context_set_fill_color(ctx, background);
+    draw_score_image(get_current_region_score(time), ctx, layer, get_layout()->score_image[time], SCORE_IMAGE_SIZE,
+                     background);
+}
+
+#ifdef UI_SINGLE_LAYER
+static const char *const s_time_labels[2] = {"Morning", "Afternoon"};
+
+// Shrinks a text box to the height its text needs, measured once per window load
+static GRect measure_text(const char *text, GFont font, GRect box, GTextAlignment alignment)
+{
+    GSize size = graphics_text_layout_get_content_size(text, font, box, GTextOverflowModeWordWrap, alignment);
+    return GRect(box.origin.x, box.origin.y, box.size.w, size.h < box.size.h ? size.h : box.size.h);
+}
+
+static void measure_main_text(void)
+{
+    const Layout *layout = get_layout();
+    s_label_font = fonts_get_system_font(LABEL_FONT);
+    s_date_font = fonts_get_system_font(DATE_FONT);
+
+    for (TimePeriod time = TIME_MORNING; time <= TIME_AFTERNOON; time++)
+    {
+        s_label_text_rects[time] =
+            measure_text(s_time_labels[time], s_label_font, layout->time_label[time], GTextAlignmentLeft);
+        for (ScoreBucket bucket = 0; bucket < SCORE_BUCKET_COUNT; bucket++)
+        {
+            ScoreLines lines = bucket == SCORE_BUCKET_VISIBLE ? SCORE_LINES_ONE : SCORE_LINES_TWO;
+            s_score_text_rects[time][bucket] = measure_text(get_score_bucket_text(bucket), s_label_font,
+                                                            layout->score_bubble[time][lines], GTextAlignmentCenter);
+        }
+    }
+}
+
+static void draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextAlignment alignment, GColor color)
+{
+    graphics_context_set_text_color(ctx, color);
+    graphics_draw_text(ctx, text, font, box, GTextOverflowModeWordWrap, alignment, NULL);
+}
+
+static void draw_main_text(GContext *ctx)
+{
+    const Layout *layout = get_layout();
+
+    draw_text(ctx, s_date_buffer, s_date_font, layout->date_text,
+              PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft), DATE_TEXT_COLOR);
+    draw_text(ctx, get_region_name(get_current_region()), s_label_font, layout->region_text, GTextAlignmentCenter,
+              REGION_TEXT_COLOR);
+    draw_text(ctx, s_time_labels[TIME_MORNING], s_label_font, s_label_text_rects[TIME_MORNING], GTextAlignmentLeft,
+              TIME_MORNING_TEXT_COLOR);
+    draw_text(ctx, s_time_labels[TIME_AFTERNOON], s_label_font, s_label_text_rects[TIME_AFTERNOON],
+              GTextAlignmentLeft, TIME_AFTERNOON_TEXT_COLOR);
+
+    for (TimePeriod time = TIME_MORNING; time <= TIME_AFTERNOON; time++)
+    {
+        // A missing score takes the two line box of the bucket it is drawn with
+        int8_t score = get_current_region_score(time);
+        ScoreBucket bucket = get_score_bucket(score);
+        draw_text(ctx, get_score_text(score), s_label_font, s_score_text_rects[time][bucket], GTextAlignmentCenter,
+                  SCORE_TEXT_COLOR);
+    }
+}
+#endif
+
+static void end_frame(void)
+{
+    trace_mark(TRACE_FRAME_DRAWN);
+    render_stats_frame_end(get_score_bucket(get_current_region_score(TIME_MORNING)),
+                           get_score_bucket(get_current_region_score(TIME_AFTERNOON)));
 }
 
 static void canvas_update_proc(Layer *layer, GContext *ctx)
 {
-    GRect bounds = layer_get_bounds(layer);
+    const Layout *layout = get_layout();
+    render_stats_frame_begin();
 
     // Main background
     graphics_context_set_fill_color(ctx, BACKGROUND_BUBBLE_COLOR);
-    graphics_fill_rect(ctx, bounds, CORNER_RADIUS_MAIN, GCornersAll);
+    graphics_fill_rect(ctx, layer_get_bounds(layer), CORNER_RADIUS_MAIN, GCornersAll);
 
-    int16_t region_inset = bounds.size.w - PADDING - REGION_BUBBLE_WIDTH;
-#ifdef PBL_ROUND
-    region_inset = (bounds.size.w - REGION_BUBBLE_WIDTH) / 2;
-#endif
-    // Region bubble at top right for rectangular displays
+    // Region bubble at top right for rectangular displays, top center for round
     graphics_context_set_fill_color(ctx, REGION_BUBBLE_COLOR);
-    graphics_fill_rect(ctx, GRect(region_inset, PADDING, REGION_BUBBLE_WIDTH, REGION_BUBBLE_HEIGHT),
-                       CORNER_RADIUS_BUBBLE, GCornersAll);
+    graphics_fill_rect(ctx, layout->region_bubble, CORNER_RADIUS_BUBBLE, GCornersAll);
 
     // Morning/Afternoon sections
     graphics_context_set_fill_color(ctx, TIME_MORNING_BUBBLE_COLOR);
-    graphics_fill_rect(ctx, calculate_bubble_rect(TIME_MORNING, bounds), CORNER_RADIUS_MAIN, GCornersAll);
+    graphics_fill_rect(ctx, layout->time_bubble[TIME_MORNING], CORNER_RADIUS_MAIN, GCornersAll);
     graphics_context_set_fill_color(ctx, TIME_AFTERNOON_BUBBLE_COLOR);
-    graphics_fill_rect(ctx, calculate_bubble_rect(TIME_AFTERNOON, bounds), CORNER_RADIUS_MAIN, GCornersAll);
+    graphics_fill_rect(ctx, layout->time_bubble[TIME_AFTERNOON], CORNER_RADIUS_MAIN, GCornersAll);
 
     // Score indicators
     draw_score_bubble(ctx, layer, TIME_MORNING);
     draw_score_bubble(ctx, layer, TIME_AFTERNOON);
+
+#ifdef UI_SINGLE_LAYER
+    draw_main_text(ctx);
+    draw_time_score_image(ctx, layer, TIME_MORNING);
+    draw_time_score_image(ctx, layer, TIME_AFTERNOON);
+    end_frame();
+#endif
 }
 
-static void morning_score_image_layer_update_proc(Layer *layer, GContext *ctx)
+#ifdef UI_SINGLE_LAYER
+static void main_window_load(Window *window)
 {
-    GRect bounds = layer_get_bounds(layer);
-    GRect bubble_rect = calculate_bubble_rect(TIME_MORNING, bounds);
+    window_set_background_color(window, WINDOW_COLOR);
+    Layer *window_layer = window_get_root_layer(window);
 
-    graphics_context_set_stroke_width(ctx, DRAWING_STROKE);
-    graphics_context_set_fill_color(ctx, TIME_MORNING_BUBBLE_COLOR);
-#ifdef PBL_ROUND
-    const int16_t icon_size = PLATFORM_SCALE(24);
-    draw_score_image(get_current_region_score(TIME_MORNING), ctx,
-                     GPoint(bubble_rect.origin.x + PLATFORM_SCALE(15), bubble_rect.origin.y + PADDING), icon_size);
+    // Build the score image shapes once so redraws only issue draw calls
+    score_image_geometry_init(SCORE_IMAGE_SIZE);
+    measure_main_text();
+
+    // One layer draws the whole screen
+    s_canvas_layer = layer_create(layer_get_bounds(window_layer));
+    layer_set_update_proc(s_canvas_layer, canvas_update_proc);
+    layer_add_child(window_layer, s_canvas_layer);
+
+    // Initial display update
+    s_rendered.valid = false;
+    update_all();
+    memory_stats_log("main_window_load");
+}
+
+static void main_window_unload(Window *window)
+{
+    layer_destroy(s_canvas_layer);
+    score_image_cache_deinit();
+    s_canvas_layer = NULL;
+    s_rendered.valid = false;
+    memory_stats_log("main_window_unload");
+}
 #else
-    draw_score_image(get_current_region_score(TIME_MORNING), ctx,
-                     GPoint(PLATFORM_SCALE(24), bubble_rect.origin.y + PADDING), DRAWING_SIZE);
-#endif
+static void morning_score_image_layer_update_proc(Layer *layer, GContext *ctx)
+{
+    draw_time_score_image(ctx, layer, TIME_MORNING);
 }
 
 static void afternoon_score_image_layer_update_proc(Layer *layer, GContext *ctx)
 {
-    GRect bounds = layer_get_bounds(layer);
-    GRect bubble_rect = calculate_bubble_rect(TIME_AFTERNOON, bounds);
-
-    graphics_context_set_stroke_width(ctx, DRAWING_STROKE);
-    graphics_context_set_fill_color(ctx, TIME_AFTERNOON_BUBBLE_COLOR);
-#ifdef PBL_ROUND
-    const int16_t icon_size = PLATFORM_SCALE(24);
-    draw_score_image(get_current_region_score(TIME_AFTERNOON), ctx,
-                     GPoint(bubble_rect.origin.x + PLATFORM_SCALE(15), bubble_rect.origin.y + PADDING), icon_size);
-#else
-    draw_score_image(get_current_region_score(TIME_AFTERNOON), ctx,
-                     GPoint(PLATFORM_SCALE(24), bubble_rect.origin.y + PADDING), DRAWING_SIZE);
-#endif
+    draw_time_score_image(ctx, layer, TIME_AFTERNOON);
+    // Last layer of the tree, so the frame is complete
+    end_frame();
 }
 
 static void main_window_load(Window *window)
@@ -143,6 +280,10 @@ static void main_window_load(Window *window)
     window_set_background_color(window, WINDOW_COLOR);
     Layer *window_layer = window_get_root_layer(window);
     GRect bounds = layer_get_bounds(window_layer);
+    const Layout *layout = get_layout();
+
+    // Build the score image shapes once so redraws only issue draw calls
+    score_image_geometry_init(SCORE_IMAGE_SIZE);
 
     // Create canvas layer for custom drawing
     s_canvas_layer = layer_create(bounds);
@@ -153,24 +294,12 @@ static void main_window_load(Window *window)
     s_data_layer = layer_create(bounds);
     layer_add_child(window_layer, s_data_layer);
 
-#ifdef PBL_ROUND
-    // Date layer at bottom center for round displays
-    s_date_layer = text_layer_create(GRect(PADDING, bounds.size.h - REGION_BUBBLE_HEIGHT - PADDING,
-                                           bounds.size.w - PADDING * 2, REGION_BUBBLE_HEIGHT));
-    text_layer_set_text_alignment(s_date_layer, GTextAlignmentCenter);
+    // Date layer at bottom center for round displays, top left for rectangular displays
+    s_date_layer = text_layer_create(layout->date_text);
+    text_layer_set_text_alignment(s_date_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
 
-    // Region layer at top center for round displays
-    int16_t region_x = (bounds.size.w - REGION_BUBBLE_WIDTH) / 2;
-    s_region_layer = text_layer_create(GRect(region_x + 4, PADDING, REGION_BUBBLE_WIDTH - 8, REGION_BUBBLE_HEIGHT));
-#else
-    // Date layer (top left) for rectangular displays
-    s_date_layer = text_layer_create(GRect(PADDING, PADDING, bounds.size.w - PADDING * 2, REGION_BUBBLE_HEIGHT));
-    text_layer_set_text_alignment(s_date_layer, GTextAlignmentLeft);
-
-    // Region layer (top right bubble) for rectangular displays
-    s_region_layer = text_layer_create(GRect(bounds.size.w - PADDING - REGION_BUBBLE_WIDTH + 4, PADDING,
-                                             REGION_BUBBLE_WIDTH - 8, REGION_BUBBLE_HEIGHT));
-#endif
+    // Region layer in the region bubble
+    s_region_layer = text_layer_create(layout->region_text);
 
     text_layer_set_background_color(s_date_layer, GColorClear);
     text_layer_set_text_color(s_date_layer, DATE_TEXT_COLOR);
@@ -184,16 +313,7 @@ static void main_window_load(Window *window)
     layer_add_child(s_data_layer, text_layer_get_layer(s_region_layer));
 
     // Morning label
-#ifdef PBL_ROUND
-    GRect morning_bubble = calculate_bubble_rect(TIME_MORNING, bounds);
-    s_morning_label_layer =
-        text_layer_create(GRect(morning_bubble.origin.x + PADDING, morning_bubble.origin.y + PLATFORM_SCALE(36),
-                                bounds.size.w / 2 - PADDING * 3, REGION_BUBBLE_HEIGHT));
-#else
-    s_morning_label_layer = text_layer_create(
-        GRect(round(PADDING * 2.5), calculate_bubble_rect(TIME_MORNING, bounds).origin.y + (REGION_BUBBLE_HEIGHT * 2),
-              bounds.size.w / 2 - PADDING * 3, REGION_BUBBLE_HEIGHT));
-#endif
+    s_morning_label_layer = text_layer_create(layout->time_label[TIME_MORNING]);
     text_layer_set_background_color(s_morning_label_layer, GColorClear);
     text_layer_set_text_color(s_morning_label_layer, TIME_MORNING_TEXT_COLOR);
     text_layer_set_font(s_morning_label_layer, fonts_get_system_font(LABEL_FONT));
@@ -201,16 +321,7 @@ static void main_window_load(Window *window)
     layer_add_child(s_data_layer, text_layer_get_layer(s_morning_label_layer));
 
     // Afternoon label
-#ifdef PBL_ROUND
-    GRect afternoon_bubble = calculate_bubble_rect(TIME_AFTERNOON, bounds);
-    s_afternoon_label_layer =
-        text_layer_create(GRect(afternoon_bubble.origin.x + PADDING, afternoon_bubble.origin.y + PLATFORM_SCALE(36),
-                                bounds.size.w / 2, REGION_BUBBLE_HEIGHT));
-#else
-    s_afternoon_label_layer = text_layer_create(
-        GRect(PADDING * 2, calculate_bubble_rect(TIME_AFTERNOON, bounds).origin.y + (REGION_BUBBLE_HEIGHT * 2),
-              bounds.size.w / 2, REGION_BUBBLE_HEIGHT));
-#endif
+    s_afternoon_label_layer = text_layer_create(layout->time_label[TIME_AFTERNOON]);
     text_layer_set_background_color(s_afternoon_label_layer, GColorClear);
     text_layer_set_text_color(s_afternoon_label_layer, TIME_AFTERNOON_TEXT_COLOR);
     text_layer_set_font(s_afternoon_label_layer, fonts_get_system_font(LABEL_FONT));
@@ -218,14 +329,14 @@ static void main_window_load(Window *window)
     layer_add_child(s_data_layer, text_layer_get_layer(s_afternoon_label_layer));
 
     // Score layers
-    s_morning_score_layer = text_layer_create(calculate_score_rect(TIME_MORNING, bounds, 2));
+    s_morning_score_layer = text_layer_create(layout->score_bubble[TIME_MORNING][SCORE_LINES_TWO]);
     text_layer_set_background_color(s_morning_score_layer, GColorClear);
     text_layer_set_text_color(s_morning_score_layer, SCORE_TEXT_COLOR);
     text_layer_set_font(s_morning_score_layer, fonts_get_system_font(LABEL_FONT));
     text_layer_set_text_alignment(s_morning_score_layer, GTextAlignmentCenter);
     layer_add_child(s_data_layer, text_layer_get_layer(s_morning_score_layer));
 
-    s_afternoon_score_layer = text_layer_create(calculate_score_rect(TIME_AFTERNOON, bounds, 2));
+    s_afternoon_score_layer = text_layer_create(layout->score_bubble[TIME_AFTERNOON][SCORE_LINES_TWO]);
     text_layer_set_background_color(s_afternoon_score_layer, GColorClear);
     text_layer_set_text_color(s_afternoon_score_layer, SCORE_TEXT_COLOR);
     text_layer_set_font(s_afternoon_score_layer, fonts_get_system_font(LABEL_FONT));
@@ -241,7 +352,9 @@ static void main_window_load(Window *window)
     layer_add_child(s_data_layer, s_afternoon_score_image_layer);
 
     // Initial display update
+    s_rendered.valid = false;
     update_all();
+    memory_stats_log("main_window_load");
 }
 
 static void main_window_unload(Window *window)
@@ -256,34 +369,59 @@ static void main_window_unload(Window *window)
     text_layer_destroy(s_afternoon_score_layer);
     layer_destroy(s_morning_score_image_layer);
     layer_destroy(s_afternoon_score_image_layer);
+    score_image_cache_deinit();
+    s_canvas_layer = NULL;
+    s_rendered.valid = false;
+    memory_stats_log("main_window_unload");
 }
+#endif
 
 void draw_score_bubble(GContext *ctx, Layer *layer, TimePeriod time)
 {
     int8_t score = get_current_region_score(time);
-    GRect bounds = layer_get_bounds(layer);
-    int8_t line_count = score >= 8 ? 1 : 2;
     graphics_context_set_fill_color(ctx, get_score_bubble_color(score));
-    graphics_fill_rect(ctx, calculate_score_rect(time, bounds, line_count), CORNER_RADIUS_BUBBLE, GCornersAll);
+    graphics_fill_rect(ctx, get_layout()->score_bubble[time][get_score_lines(score)], CORNER_RADIUS_BUBBLE,
+                       GCornersAll);
 }
 
-void update_score(TimePeriod time)
+static void refresh_score(TimePeriod time)
 {
-    TextLayer *layer = (time == TIME_MORNING) ? s_morning_score_layer : s_afternoon_score_layer;
-    GRect bounds = layer_get_bounds((Layer *)s_main_window);
     int8_t score = get_current_region_score(time);
-    int8_t line_count = score >= 8 ? 1 : 2;
+    ScoreBucket bucket = get_score_bucket(score);
+    bool missing = score < 0;
+    if (s_rendered.valid && s_rendered.buckets[time] == bucket && s_rendered.missing[time] == missing)
+        return;
+
+    // Text, bubble colour and image all follow the bucket and whether there is a score, not the raw score
+    layer_mark_dirty(s_canvas_layer);
+#ifndef UI_SINGLE_LAYER
+    TextLayer *layer = (time == TIME_MORNING) ? s_morning_score_layer : s_afternoon_score_layer;
     text_layer_set_text(layer, get_score_text(score));
-    layer_set_frame((Layer *)layer, calculate_score_rect(time, bounds, line_count));
+    layer_set_frame((Layer *)layer, get_layout()->score_bubble[time][get_score_lines(score)]);
     layer_mark_dirty((time == TIME_MORNING) ? s_morning_score_image_layer : s_afternoon_score_image_layer);
+#endif
+    s_rendered.buckets[time] = bucket;
+    s_rendered.missing[time] = missing;
+}
+
+void update_score(TimePeriod time)
+{
+    if (!s_canvas_layer)
+        return;
+
+    refresh_score(time);
 }
 
 void update_all(void)
 {
+    if (!s_canvas_layer)
+        return;
+
     update_date();
     update_region();
-    update_score(TIME_MORNING);
-    update_score(TIME_AFTERNOON);
+    refresh_score(TIME_MORNING);
+    refresh_score(TIME_AFTERNOON);
+    s_rendered.valid = true;
 }
 
 static void loading_window_load(Window *window)
@@ -301,14 +439,14 @@ static void loading_window_load(Window *window)
     layer_add_child(window_layer, bitmap_layer_get_layer(s_loading_bitmap_layer));
 
     // Loading text
-    s_loading_text_layer =
-        text_layer_create(GRect(0, bounds.size.h / 2 + LOADING_TEXT_Y_PADDING, bounds.size.w, LOADING_TEXT_HEIGHT));
+    s_loading_text_layer = text_layer_create(get_layout()->loading_text);
     text_layer_set_background_color(s_loading_text_layer, GColorClear);
     text_layer_set_text_color(s_loading_text_layer, GColorBlack);
     text_layer_set_font(s_loading_text_layer, fonts_get_system_font(LOADING_FONT));
     text_layer_set_text_alignment(s_loading_text_layer, GTextAlignmentCenter);
     text_layer_set_text(s_loading_text_layer, "Loading...");
     layer_add_child(window_layer, text_layer_get_layer(s_loading_text_layer));
+    memory_stats_log("loading_window_load");
 }
 
 static void loading_window_unload(Window *window)
@@ -316,6 +454,7 @@ static void loading_window_unload(Window *window)
     text_layer_destroy(s_loading_text_layer);
     bitmap_layer_destroy(s_loading_bitmap_layer);
     gbitmap_destroy(s_loading_bitmap);
+    memory_stats_log("loading_window_unload");
 }
 
 void show_main_window(void)
@@ -335,11 +474,12 @@ void show_main_window(void)
 
     window_destroy(s_loading_window);
     s_loading_window = NULL;
+    trace_mark(TRACE_MAIN_WINDOW_SHOWN);
 }
 
 void ui_init(void)
 {
-    if (get_data_loaded_progress() == 4)
+    if (is_data_loaded())
     {
         s_main_window = window_create();
         window_set_window_handlers(s_main_window, (WindowHandlers){
@@ -1,72 +1,113 @@
 #include "graphics.h"
+#include "render_stats.h"
 #include <math.h>
 
-static void draw_sun(GContext *ctx, GPoint pos, int16_t size)
+#define SUN_RAY_COUNT 8
+#define CLOUD_SEGMENT_COUNT 16
+#define CLOUD_POINT_COUNT (CLOUD_SEGMENT_COUNT + 1)
+#define SCORE_IMAGE_CACHE_SIZE 8
+#define SCORE_IMAGE_STROKE_MARGIN 3
+
+typedef enum
+{
+    SCORE_IMAGE_SUN = 0,
+    SCORE_IMAGE_PARTLY_CLOUDY = 1,
+    SCORE_IMAGE_MOSTLY_CLOUDY = 2,
+    SCORE_IMAGE_VERY_CLOUDY = 3,
+    SCORE_IMAGE_COUNT = 4
+} ScoreImage;
+
+// Sun vertices relative to the top left of the drawing
+typedef struct
+{
+    GPoint box[4];
+    GPoint rays[SUN_RAY_COUNT][2];
+} SunGeometry;
+
+// Cloud vertices relative to the top left of the drawing, shared by the fill path and the outline
+typedef struct
+{
+    GPoint points[CLOUD_POINT_COUNT];
+    GPath path;
+} CloudGeometry;
+
+// Every shape needed by the score images for a single drawing size
+typedef struct
+{
+    int16_t size;
+    SunGeometry sun;
+    SunGeometry small_sun;
+    CloudGeometry small_cloud;
+    CloudGeometry cloud;
+    CloudGeometry reduced_cloud;
+    GPoint partly_cloudy_cloud_offset;
+    GPoint mostly_cloudy_sun_offset;
+    GPoint mostly_cloudy_cloud_offset;
+    int16_t very_cloudy_adjustment;
+    GRect bounds[SCORE_IMAGE_COUNT];
+} ScoreImageGeometry;
+
+// A rendered score image captured with the pixels behind it, valid only for the spot on screen it was captured
+// from and over the same background colour
+typedef struct
+{
+    GBitmap *bitmap;
+    GRect screen_rect;
+    GColor background;
+    ScoreImage image;
+} ScoreImageCacheEntry;
+
+static ScoreImageGeometry s_geometry;
+static ScoreImageCacheEntry s_cache[SCORE_IMAGE_CACHE_SIZE];
+static uint8_t s_cache_next;
+
+static void build_sun(SunGeometry *sun, int16_t size)
 {
     const int16_t ray_length = round(size * 0.15);
     const int16_t angle_ray_length = round(size * 0.12);
     const int16_t sun_box_size = round(size * 0.46);
     const int16_t gap = round((size - sun_box_size - (ray_length * 2)) / 2);
-    const int16_t center_x = pos.x + size / 2;
-    const int16_t center_y = pos.y + size / 2;
-
-    graphics_context_set_stroke_color(ctx, SCORE_SUN_COLOR);
+    const int16_t center_x = size / 2;
+    const int16_t center_y = size / 2;
+    const int16_t box_start = ray_length + gap;
+    const int16_t box_end = box_start + sun_box_size;
 
     // Sun Box
-    GPoint top_left = GPoint(ray_length + gap + pos.x, ray_length + gap + pos.y);
-    GPoint top_right = GPoint(ray_length + gap + pos.x + sun_box_size, ray_length + gap + pos.y);
-    GPoint bottom_left = GPoint(ray_length + gap + pos.x, ray_length + gap + pos.y + sun_box_size);
-    GPoint bottom_right = GPoint(ray_length + gap + pos.x + sun_box_size, ray_length + gap + pos.y + sun_box_size);
-
-    graphics_draw_line(ctx, top_left, top_right);       // Top
-    graphics_draw_line(ctx, top_right, bottom_right);   // Right
-    graphics_draw_line(ctx, bottom_right, bottom_left); // Bottom
-    graphics_draw_line(ctx, bottom_left, top_left);     // Left
-
-    // Define ray positions
-    const struct
-    {
-        GPoint start;
-        GPoint end;
-    } rays[] = {
-        // Straight rays
-        {GPoint(center_x, pos.y), GPoint(center_x, pos.y + ray_length)},               // Top
-        {GPoint(center_x, pos.y + size - ray_length), GPoint(center_x, pos.y + size)}, // Bottom
-        {GPoint(pos.x, center_y), GPoint(pos.x + ray_length, center_y)},               // Left
-        {GPoint(pos.x + size - ray_length, center_y), GPoint(pos.x + size, center_y)}, // Right
-
-        // Diagonal rays
-        {GPoint(pos.x + gap, pos.y + gap),
-         GPoint(pos.x + gap + angle_ray_length, pos.y + gap + angle_ray_length)}, // Top-left
-        {GPoint(pos.x + size - gap, pos.y + gap),
-         GPoint(pos.x + size - gap - angle_ray_length, pos.y + gap + angle_ray_length)}, // Top-right
-        {GPoint(pos.x + gap, pos.y + size - gap),
-         GPoint(pos.x + gap + angle_ray_length, pos.y + size - gap - angle_ray_length)}, // Bottom-left
-        {GPoint(pos.x + size - gap, pos.y + size - gap),
-         GPoint(pos.x + size - gap - angle_ray_length, pos.y + size - gap - angle_ray_length)} // Bottom-right
-    };
+    sun->box[0] = GPoint(box_start, box_start); // Top left
+    sun->box[1] = GPoint(box_end, box_start);   // Top right
+    sun->box[2] = GPoint(box_end, box_end);     // Bottom right
+    sun->box[3] = GPoint(box_start, box_end);   // Bottom left
 
-    // Draw each ray
-    for (size_t i = 0; i < sizeof(rays) / sizeof(rays[0]); i++)
-    {
-        graphics_draw_line(ctx, rays[i].start, rays[i].end);
-    }
+    // Straight rays
+    sun->rays[0][0] = GPoint(center_x, 0); // Top
+    sun->rays[0][1] = GPoint(center_x, ray_length);
+    sun->rays[1][0] = GPoint(center_x, size - ray_length); // Bottom
+    sun->rays[1][1] = GPoint(center_x, size);
+    sun->rays[2][0] = GPoint(0, center_y); // Left
+    sun->rays[2][1] = GPoint(ray_length, center_y);
+    sun->rays[3][0] = GPoint(size - ray_length, center_y); // Right
+    sun->rays[3][1] = GPoint(size, center_y);
+
+    // Diagonal rays
+    sun->rays[4][0] = GPoint(gap, gap); // Top-left
+    sun->rays[4][1] = GPoint(gap + angle_ray_length, gap + angle_ray_length);
+    sun->rays[5][0] = GPoint(size - gap, gap); // Top-right
+    sun->rays[5][1] = GPoint(size - gap - angle_ray_length, gap + angle_ray_length);
+    sun->rays[6][0] = GPoint(gap, size - gap); // Bottom-left
+    sun->rays[6][1] = GPoint(gap + angle_ray_length, size - gap - angle_ray_length);
+    sun->rays[7][0] = GPoint(size - gap, size - gap); // Bottom-right
+    sun->rays[7][1] = GPoint(size - gap - angle_ray_length, size - gap - angle_ray_length);
 }
 
-static void draw_cloud(GContext *ctx, GPoint pos, int16_t size, bool fill)
+static void build_cloud(CloudGeometry *cloud, int16_t size)
 {
-    const int16_t center_x = pos.x + (size / 2);
-    const int16_t top_y = pos.y + 16;
-
-    graphics_context_set_stroke_color(ctx, SCORE_CLOUD_COLOR);
-
     // Define line segments as relative movements {dx, dy, length}
-    const struct
+    static const struct
     {
         int8_t dx;
         int8_t dy;
         float scale;
-    } segments[] = {
+    } segments[CLOUD_SEGMENT_COUNT] = {
         {-1, 0, 0.19},  // half 1 upper top
         {-1, 1, 0.11},  // half 1 upper top left
         {0, 1, 0.13},   // half 1 upper left
@@ -85,71 +126,351 @@ static void draw_cloud(GContext *ctx, GPoint pos, int16_t size, bool fill)
         {-1, 0, 0.11},  // half 2 upper top
     };
 
-    // Create path for filling
+    // First point
+    GPoint current = GPoint(size / 2, 16);
+    cloud->points[0] = current;
+
+    // Generate path points
+    for (size_t i = 0; i < CLOUD_SEGMENT_COUNT; i++)
+    {
+        int16_t length = round(size * segments[i].scale);
+        current.x += segments[i].dx * length;
+        current.y += segments[i].dy * length;
+        cloud->points[i + 1] = current;
+    }
+
+    cloud->path = (GPath){.num_points = CLOUD_POINT_COUNT, .points = cloud->points};
+}
+
+static void include_point(GRect *rect, GPoint point)
+{
+    if (point.x < rect->origin.x)
+    {
+        rect->size.w += rect->origin.x - point.x;
+        rect->origin.x = point.x;
+    }
+    if (point.y < rect->origin.y)
+    {
+        rect->size.h += rect->origin.y - point.y;
+        rect->origin.y = point.y;
+    }
+    if (point.x > rect->origin.x + rect->size.w)
+        rect->size.w = point.x - rect->origin.x;
+    if (point.y > rect->origin.y + rect->size.h)
+        rect->size.h = point.y - rect->origin.y;
+}
+
+static void include_sun(GRect *rect, const SunGeometry *sun, GPoint offset)
+{
+    for (size_t i = 0; i < SUN_RAY_COUNT; i++)
+    {
+        include_point(rect, GPoint(sun->rays[i][0].x + offset.x, sun->rays[i][0].y + offset.y));
+        include_point(rect, GPoint(sun->rays[i][1].x + offset.x, sun->rays[i][1].y + offset.y));
+    }
+}
+
+static void include_cloud(GRect *rect, const CloudGeometry *cloud, GPoint offset)
+{
+    for (size_t i = 0; i < CLOUD_POINT_COUNT; i++)
+    {
+        include_point(rect, GPoint(cloud->points[i].x + offset.x, cloud->points[i].y + offset.y));
+    }
+}
+
+static GRect expand_by_stroke(GRect rect)
+{
+    return GRect(rect.origin.x - SCORE_IMAGE_STROKE_MARGIN, rect.origin.y - SCORE_IMAGE_STROKE_MARGIN,
+                 rect.size.w + SCORE_IMAGE_STROKE_MARGIN * 2 + 1, rect.size.h + SCORE_IMAGE_STROKE_MARGIN * 2 + 1);
+}
+
+// Bounds of each image relative to its drawing position, very cloudy excluding its position based shift
+static void build_bounds(void)
+{
+    const int16_t adjustment_size = s_geometry.very_cloudy_adjustment;
+    GRect *bounds = s_geometry.bounds;
+
+    bounds[SCORE_IMAGE_SUN] = GRect(0, 0, 0, 0);
+    include_sun(&bounds[SCORE_IMAGE_SUN], &s_geometry.sun, GPointZero);
+
+    bounds[SCORE_IMAGE_PARTLY_CLOUDY] = bounds[SCORE_IMAGE_SUN];
+    include_cloud(&bounds[SCORE_IMAGE_PARTLY_CLOUDY], &s_geometry.small_cloud, s_geometry.partly_cloudy_cloud_offset);
+
+    bounds[SCORE_IMAGE_MOSTLY_CLOUDY] = GRect(s_geometry.mostly_cloudy_sun_offset.x, 0, 0, 0);
+    include_sun(&bounds[SCORE_IMAGE_MOSTLY_CLOUDY], &s_geometry.small_sun, s_geometry.mostly_cloudy_sun_offset);
+    include_cloud(&bounds[SCORE_IMAGE_MOSTLY_CLOUDY], &s_geometry.cloud, s_geometry.mostly_cloudy_cloud_offset);
+
+    bounds[SCORE_IMAGE_VERY_CLOUDY] = GRect(0, s_geometry.reduced_cloud.points[0].y, 0, 0);
+    include_cloud(&bounds[SCORE_IMAGE_VERY_CLOUDY], &s_geometry.reduced_cloud,
+                  GPoint(adjustment_size * 3, -adjustment_size * 2));
+    include_cloud(&bounds[SCORE_IMAGE_VERY_CLOUDY], &s_geometry.reduced_cloud, GPointZero);
+
+    for (size_t i = 0; i < SCORE_IMAGE_COUNT; i++)
+    {
+        bounds[i] = expand_by_stroke(bounds[i]);
+    }
+}
+
+void score_image_geometry_init(int16_t size)
+{
+    const int16_t small_size = size * 0.66;
+    const int16_t adjustment_size = round(size * 0.1);
+
+    s_geometry.size = size;
+
+    build_sun(&s_geometry.sun, size);
+    build_sun(&s_geometry.small_sun, small_size);
+    build_cloud(&s_geometry.small_cloud, small_size);
+    build_cloud(&s_geometry.cloud, size);
+    build_cloud(&s_geometry.reduced_cloud, size - adjustment_size);
+
+    s_geometry.partly_cloudy_cloud_offset = GPoint(0, (int16_t)(size * 0.07));
+    s_geometry.mostly_cloudy_sun_offset = GPoint((int16_t)(size - size * 0.66), 0);
+    s_geometry.mostly_cloudy_cloud_offset = GPoint(0, -(int16_t)ceil(size * 0.14));
+    s_geometry.very_cloudy_adjustment = adjustment_size;
+
+    build_bounds();
+
+    // Captured images no longer match the new shapes
+    score_image_cache_deinit();
+}
+
+static inline GPoint offset_point(GPoint point, GPoint pos)
+{
+    return GPoint(point.x + pos.x, point.y + pos.y);
+}
+
+static void draw_sun(GContext *ctx, const SunGeometry *sun, GPoint pos)
+{
+    graphics_context_set_stroke_color(ctx, SCORE_SUN_COLOR);
+
+    // Sun Box
+    for (size_t i = 0; i < 4; i++)
+    {
+        graphics_draw_line(ctx, offset_point(sun->box[i], pos), offset_point(sun->box[(i + 1) % 4], pos));
+    }
+
+    // Draw each ray
+    for (size_t i = 0; i < SUN_RAY_COUNT; i++)
+    {
+        graphics_draw_line(ctx, offset_point(sun->rays[i][0], pos), offset_point(sun->rays[i][1], pos));
+    }
+}
+
+static void draw_cloud(GContext *ctx, CloudGeometry *cloud, GPoint pos, bool fill)
+{
+    graphics_context_set_stroke_color(ctx, SCORE_CLOUD_COLOR);
+
     if (fill)
     {
-        GPath *path =
-            gpath_create(&(GPathInfo){.num_points = sizeof(segments) / sizeof(segments[0]) + 1,
-                                      .points = malloc(sizeof(GPoint) * (sizeof(segments) / sizeof(segments[0]) + 1))});
+        gpath_move_to(&cloud->path, pos);
+        gpath_draw_filled(ctx, &cloud->path);
+    }
+
+    // Draw outline
+    for (size_t i = 0; i < CLOUD_SEGMENT_COUNT; i++)
+    {
+        graphics_draw_line(ctx, offset_point(cloud->points[i], pos), offset_point(cloud->points[i + 1], pos));
+    }
+}
+
+static void draw_partly_cloudy(GContext *ctx, GPoint pos)
+{
+    draw_sun(ctx, &s_geometry.sun, pos);
+    draw_cloud(ctx, &s_geometry.small_cloud, offset_point(s_geometry.partly_cloudy_cloud_offset, pos), true);
+}
+
+static void draw_mostly_cloudy(GContext *ctx, GPoint pos)
+{
+    draw_sun(ctx, &s_geometry.small_sun, offset_point(s_geometry.mostly_cloudy_sun_offset, pos));
+    draw_cloud(ctx, &s_geometry.cloud, offset_point(s_geometry.mostly_cloudy_cloud_offset, pos), true);
+}
+
+static void draw_very_cloudy(GContext *ctx, GPoint pos)
+{
+    int16_t adjustment_y = -((pos.x + 5) / 10);
+    int16_t adjustment_size = s_geometry.very_cloudy_adjustment;
+    draw_cloud(ctx, &s_geometry.reduced_cloud,
+               GPoint(pos.x + adjustment_size * 3, pos.y + adjustment_y - adjustment_size * 2), true);
+    draw_cloud(ctx, &s_geometry.reduced_cloud, GPoint(pos.x, pos.y + adjustment_y), true);
+}
+
+static ScoreImage get_score_image(int8_t score)
+{
+    if (score >= 8)
+        return SCORE_IMAGE_SUN;
+    if (score >= 6)
+        return SCORE_IMAGE_PARTLY_CLOUDY;
+    if (score >= 3)
+        return SCORE_IMAGE_MOSTLY_CLOUDY;
+    return SCORE_IMAGE_VERY_CLOUDY;
+}
+
+static GRect get_score_image_rect(ScoreImage image, GPoint pos)
+{
+    GRect rect = s_geometry.bounds[image];
+    rect.origin.x += pos.x;
+    rect.origin.y += pos.y;
+    if (image == SCORE_IMAGE_VERY_CLOUDY)
+        rect.origin.y -= (pos.x + 5) / 10;
+    return rect;
+}
 
-        // First point
-        path->points[0] = GPoint(center_x, top_y);
-        GPoint current = path->points[0];
+static GRect clip_rect(GRect rect, GRect bounds)
+{
+    int16_t x0 = rect.origin.x > bounds.origin.x ? rect.origin.x : bounds.origin.x;
+    int16_t y0 = rect.origin.y > bounds.origin.y ? rect.origin.y : bounds.origin.y;
+    int16_t x1 = rect.origin.x + rect.size.w;
+    int16_t y1 = rect.origin.y + rect.size.h;
+    if (x1 > bounds.origin.x + bounds.size.w)
+        x1 = bounds.origin.x + bounds.size.w;
+    if (y1 > bounds.origin.y + bounds.size.h)
+        y1 = bounds.origin.y + bounds.size.h;
+    return GRect(x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0);
+}
+
+// Copies a region of the frame buffer into a new bitmap of the same pixel format
+static GBitmap *copy_frame_buffer_region(GBitmap *frame_buffer, GRect rect)
+{
+#ifdef PBL_COLOR
+    GBitmap *bitmap = gbitmap_create_blank(rect.size, GBitmapFormat8Bit);
+    if (!bitmap)
+        return NULL;
 
-        // Generate path points
-        for (size_t i = 0; i < sizeof(segments) / sizeof(segments[0]); i++)
+    uint8_t *data = gbitmap_get_data(bitmap);
+    const uint16_t bytes_per_row = gbitmap_get_bytes_per_row(bitmap);
+    for (int16_t y = 0; y < rect.size.h; y++)
+    {
+        // Row info handles the circular frame buffer on round displays
+        GBitmapDataRowInfo row = gbitmap_get_data_row_info(frame_buffer, rect.origin.y + y);
+        for (int16_t x = 0; x < rect.size.w; x++)
         {
-            int16_t length = round(size * segments[i].scale);
-            current.x += segments[i].dx * length;
-            current.y += segments[i].dy * length;
-            path->points[i + 1] = current;
+            const int16_t fb_x = rect.origin.x + x;
+            // Pixels outside the visible row stay fully transparent
+            if (fb_x >= row.min_x && fb_x <= row.max_x)
+                data[y * bytes_per_row + x] = row.data[fb_x];
         }
+    }
+#else
+    GBitmap *bitmap = gbitmap_create_blank(rect.size, GBitmapFormat1Bit);
+    if (!bitmap)
+        return NULL;
 
-        gpath_draw_filled(ctx, path);
-        free(path->points);
-        gpath_destroy(path);
+    uint8_t *data = gbitmap_get_data(bitmap);
+    const uint16_t bytes_per_row = gbitmap_get_bytes_per_row(bitmap);
+    const uint8_t *fb_data = gbitmap_get_data(frame_buffer);
+    const uint16_t fb_bytes_per_row = gbitmap_get_bytes_per_row(frame_buffer);
+    for (int16_t y = 0; y < rect.size.h; y++)
+    {
+        const uint8_t *fb_row = fb_data + (rect.origin.y + y) * fb_bytes_per_row;
+        uint8_t *row = data + y * bytes_per_row;
+        for (int16_t x = 0; x < rect.size.w; x++)
+        {
+            const int16_t fb_x = rect.origin.x + x;
+            if (fb_row[fb_x / 8] & (1 << (fb_x % 8)))
+                row[x / 8] |= 1 << (x % 8);
+        }
     }
+#endif
+    return bitmap;
+}
 
-    // Draw outline
-    GPoint current = GPoint(center_x, top_y);
-    for (size_t i = 0; i < sizeof(segments) / sizeof(segments[0]); i++)
+static ScoreImageCacheEntry *find_cache_entry(ScoreImage image, GRect screen_rect, GColor background)
+{
+    for (size_t i = 0; i < SCORE_IMAGE_CACHE_SIZE; i++)
     {
-        int16_t length = round(size * segments[i].scale);
-        GPoint next = GPoint(current.x + (segments[i].dx * length), current.y + (segments[i].dy * length));
-        graphics_draw_line(ctx, current, next);
-        current = next;
+        ScoreImageCacheEntry *entry = &s_cache[i];
+        if (entry->bitmap && entry->image == image && grect_equal(&entry->screen_rect, &screen_rect) &&
+            gcolor_equal(entry->background, background))
+            return entry;
     }
+    return NULL;
 }
 
-static void draw_partly_cloudy(GContext *ctx, GPoint pos, int16_t size)
+// The drawing context is in layer coordinates and the frame buffer in screen coordinates
+static GRect get_screen_rect(const Layer *layer, GRect rect)
 {
-    draw_sun(ctx, pos, size);
-    draw_cloud(ctx, GPoint(pos.x, pos.y + size * 0.07), size * 0.66, true);
+    const GPoint origin = layer_convert_point_to_screen(layer, rect.origin);
+    return (GRect){.origin = origin, .size = rect.size};
 }
 
-static void draw_mostly_cloudy(GContext *ctx, GPoint pos, int16_t size)
+static void capture_score_image(GContext *ctx, const Layer *layer, ScoreImage image, GRect rect, GColor background)
 {
-    draw_sun(ctx, GPoint((size - size * 0.66) + pos.x, pos.y), size * 0.66);
-    draw_cloud(ctx, GPoint(pos.x, pos.y - (size * 0.14)), size, true);
+    // Part of an image clipped by its layer is not drawn, and capturing it would pick up whatever is there instead
+    GRect clipped = clip_rect(rect, layer_get_bounds(layer));
+    if (!grect_equal(&clipped, &rect))
+        return;
+
+    GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+    if (!frame_buffer)
+        return;
+
+    const GRect screen_rect = get_screen_rect(layer, rect);
+    clipped = clip_rect(screen_rect, gbitmap_get_bounds(frame_buffer));
+    GBitmap *bitmap = NULL;
+    if (grect_equal(&clipped, &screen_rect))
+        bitmap = copy_frame_buffer_region(frame_buffer, screen_rect);
+    graphics_release_frame_buffer(ctx, frame_buffer);
+
+    if (!bitmap)
+        return;
+
+    // Replace the oldest entry once the cache is full
+    ScoreImageCacheEntry *entry = &s_cache[s_cache_next];
+    s_cache_next = (s_cache_next + 1) % SCORE_IMAGE_CACHE_SIZE;
+    if (entry->bitmap)
+        gbitmap_destroy(entry->bitmap);
+    *entry = (ScoreImageCacheEntry){
+        .bitmap = bitmap,
+        .screen_rect = screen_rect,
+        .background = background,
+        .image = image,
+    };
 }
 
-static void draw_very_cloudy(GContext *ctx, GPoint pos, int16_t size)
+void draw_score_image(int8_t score, GContext *ctx, const Layer *layer, GPoint pos, int16_t size, GColor background)
 {
-    int16_t adjustment_y = -round(pos.x * 0.1);
-    int16_t adjustment_size = round(size * 0.1);
-    draw_cloud(ctx, GPoint(pos.x + adjustment_size * 3, pos.y + adjustment_y - adjustment_size * 2),
-               size - adjustment_size, true);
-    draw_cloud(ctx, GPoint(pos.x, pos.y + adjustment_y), size - adjustment_size, true);
+    if (size != s_geometry.size)
+        score_image_geometry_init(size);
+
+    const ScoreImage image = get_score_image(score);
+    const GRect rect = get_score_image_rect(image, pos);
+
+    // Looked up where the image lands on screen, so a layer that moved draws afresh rather than blitting stale pixels
+    ScoreImageCacheEntry *entry = find_cache_entry(image, get_screen_rect(layer, rect), background);
+    if (entry)
+    {
+        graphics_context_set_compositing_mode(ctx, PBL_IF_COLOR_ELSE(GCompOpSet, GCompOpAssign));
+        graphics_draw_bitmap_in_rect(ctx, entry->bitmap, rect);
+        return;
+    }
+
+    switch (image)
+    {
+    case SCORE_IMAGE_SUN:
+        draw_sun(ctx, &s_geometry.sun, pos);
+        break;
+    case SCORE_IMAGE_PARTLY_CLOUDY:
+        draw_partly_cloudy(ctx, pos);
+        break;
+    case SCORE_IMAGE_MOSTLY_CLOUDY:
+        draw_mostly_cloudy(ctx, pos);
+        break;
+    default:
+        draw_very_cloudy(ctx, pos);
+        break;
+    }
+
+    // Reuse what was just drawn, background included, for later frames at the same spot over the same colour
+    capture_score_image(ctx, layer, image, rect, background);
 }
 
-void draw_score_image(int8_t score, GContext *ctx, GPoint pos, int16_t size)
+void score_image_cache_deinit(void)
 {
-    if (score >= 8)
-        draw_sun(ctx, pos, size);
-    else if (score >= 6)
-        draw_partly_cloudy(ctx, pos, size);
-    else if (score >= 3)
-        draw_mostly_cloudy(ctx, pos, size);
-    else
-        draw_very_cloudy(ctx, pos, size);
+    for (size_t i = 0; i < SCORE_IMAGE_CACHE_SIZE; i++)
+    {
+        if (s_cache[i].bitmap)
+            gbitmap_destroy(s_cache[i].bitmap);
+        s_cache[i] = (ScoreImageCacheEntry){0};
+    }
+    s_cache_next = 0;
 }
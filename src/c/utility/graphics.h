@@ -38,4 +38,8 @@
 #define SCORE_CLOUD_COLOR GColorWhite
 #endif
 
-void draw_score_image(int8_t score, GContext *ctx, GPoint pos, int16_t size);
\ No newline at end of file
+void score_image_geometry_init(int16_t size);
+// Draws the image for a score at pos in the layer's coordinates, over a background of the given colour. The first
+// drawing at a spot on screen is captured from the frame buffer and later ones blit the capture.
+void draw_score_image(int8_t score, GContext *ctx, const Layer *layer, GPoint pos, int16_t size, GColor background);
+void score_image_cache_deinit(void);
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifdef MEMORY_STATS
+
+#include "memory_stats.h"
+
+// Share of the app heap the app's own allocations may take. The rest is headroom for what the system allocates
+// from the same heap on the app's behalf, such as AppMessage buffers and font and text layout caches. The heap is
+// what is left of the app's RAM after code and static data (24 KB of RAM on aplite, 64 KB on basalt, chalk and
+// diorite, 128 KB on emery), so its size is measured on the first log rather than assumed per platform.
+#define HEAP_BUDGET_PERCENT 75
+
+static size_t s_heap_size;
+static size_t s_high_water;
+
+// Logs the heap after a stage, with the most used at any stage so far, and fails once it exceeds the budget
+void memory_stats_log(const char *stage)
+{
+    const size_t used = heap_bytes_used();
+    const size_t free_bytes = heap_bytes_free();
+    if (s_heap_size == 0)
+        s_heap_size = used + free_bytes;
+    if (used > s_high_water)
+        s_high_water = used;
+
+    const size_t budget = s_heap_size * HEAP_BUDGET_PERCENT / 100;
+    APP_LOG(APP_LOG_LEVEL_INFO, "[MemoryStats] %s used=%lu free=%lu high_water=%lu budget=%lu", stage,
+            (unsigned long)used, (unsigned long)free_bytes, (unsigned long)s_high_water, (unsigned long)budget);
+
+    if (used > budget)
+    {
+        APP_LOG(APP_LOG_LEVEL_ERROR, "[MemoryStats] FAIL %s used %lu exceeds budget %lu", stage, (unsigned long)used,
+                (unsigned long)budget);
+    }
+}
+
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <pebble.h>
+
+#ifdef MEMORY_STATS
+
+void memory_stats_log(const char *stage);
+
+#else
+
+#define memory_stats_log(stage)
+
+#endif
@@ -0,0 +1,139 @@
+#ifdef RENDER_STATS
+
+#define RENDER_STATS_IMPLEMENTATION
+#include "render_stats.h"
+#include "render_stats_baseline.h"
+
+static RenderStats s_frame;
+static uint8_t s_stroke_width = 1;
+
+static int16_t abs16(int16_t value)
+{
+    return value < 0 ? -value : value;
+}
+
+static uint32_t rect_area(GRect rect)
+{
+    return (uint32_t)abs16(rect.size.w) * (uint32_t)abs16(rect.size.h);
+}
+
+void render_stats_frame_begin(void)
+{
+    s_frame = (RenderStats){0};
+}
+
+const RenderStats *render_stats_get_frame(void)
+{
+    return &s_frame;
+}
+
+static bool check_stat(const char *name, uint32_t value, uint32_t baseline)
+{
+    if (value <= baseline)
+        return true;
+
+    APP_LOG(APP_LOG_LEVEL_ERROR, "[RenderStats] FAIL %s %lu exceeds baseline %lu", name, (unsigned long)value,
+            (unsigned long)baseline);
+    return false;
+}
+
+void render_stats_frame_end(ScoreBucket morning, ScoreBucket afternoon)
+{
+    const RenderStats *frame_baseline = &s_frame_baseline;
+    const RenderStats *morning_baseline = &s_image_baselines[morning];
+    const RenderStats *afternoon_baseline = &s_image_baselines[afternoon];
+
+    APP_LOG(APP_LOG_LEVEL_INFO,
+            "[RenderStats] buckets=%d/%d lines=%u paths=%u rects=%u bitmaps=%u texts=%u allocs=%u pixels=%lu",
+            morning, afternoon, s_frame.lines, s_frame.path_fills, s_frame.rect_fills, s_frame.bitmaps,
+            s_frame.texts, s_frame.allocations, (unsigned long)s_frame.pixels);
+
+    bool ok = true;
+    ok &= check_stat("lines", s_frame.lines,
+                     frame_baseline->lines + morning_baseline->lines + afternoon_baseline->lines);
+    ok &= check_stat("paths", s_frame.path_fills,
+                     frame_baseline->path_fills + morning_baseline->path_fills + afternoon_baseline->path_fills);
+    ok &= check_stat("rects", s_frame.rect_fills,
+                     frame_baseline->rect_fills + morning_baseline->rect_fills + afternoon_baseline->rect_fills);
+    ok &= check_stat("bitmaps", s_frame.bitmaps,
+                     frame_baseline->bitmaps + morning_baseline->bitmaps + afternoon_baseline->bitmaps);
+    ok &= check_stat("texts", s_frame.texts,
+                     frame_baseline->texts + morning_baseline->texts + afternoon_baseline->texts);
+    ok &= check_stat("allocs", s_frame.allocations,
+                     frame_baseline->allocations + morning_baseline->allocations + afternoon_baseline->allocations);
+    ok &= check_stat("pixels", s_frame.pixels,
+                     frame_baseline->pixels + morning_baseline->pixels + afternoon_baseline->pixels);
+
+    if (ok)
+        APP_LOG(APP_LOG_LEVEL_INFO, "[RenderStats] PASS");
+}
+
+void render_stats_draw_line(GContext *ctx, GPoint p0, GPoint p1)
+{
+    const int16_t dx = abs16(p1.x - p0.x);
+    const int16_t dy = abs16(p1.y - p0.y);
+    s_frame.lines++;
+    s_frame.pixels += (uint32_t)((dx > dy ? dx : dy) + 1) * s_stroke_width;
+    graphics_draw_line(ctx, p0, p1);
+}
+
+void render_stats_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask)
+{
+    s_frame.rect_fills++;
+    s_frame.pixels += rect_area(rect);
+    graphics_fill_rect(ctx, rect, corner_radius, corner_mask);
+}
+
+void render_stats_draw_path_filled(GContext *ctx, GPath *path)
+{
+    if (path->num_points == 0)
+        return;
+
+    // Bounding box of the path as an upper bound for the filled area
+    int16_t min_x = path->points[0].x, max_x = min_x;
+    int16_t min_y = path->points[0].y, max_y = min_y;
+    for (uint32_t i = 1; i < path->num_points; i++)
+    {
+        if (path->points[i].x < min_x)
+            min_x = path->points[i].x;
+        if (path->points[i].x > max_x)
+            max_x = path->points[i].x;
+        if (path->points[i].y < min_y)
+            min_y = path->points[i].y;
+        if (path->points[i].y > max_y)
+            max_y = path->points[i].y;
+    }
+
+    s_frame.path_fills++;
+    s_frame.pixels += (uint32_t)(max_x - min_x + 1) * (uint32_t)(max_y - min_y + 1);
+    gpath_draw_filled(ctx, path);
+}
+
+void render_stats_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect)
+{
+    s_frame.bitmaps++;
+    s_frame.pixels += rect_area(rect);
+    graphics_draw_bitmap_in_rect(ctx, bitmap, rect);
+}
+
+void render_stats_draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode,
+                            GTextAlignment alignment, GTextAttributes *text_attributes)
+{
+    s_frame.texts++;
+    s_frame.pixels += rect_area(box);
+    graphics_draw_text(ctx, text, font, box, overflow_mode, alignment, text_attributes);
+}
+
+GBitmap *render_stats_create_blank_bitmap(GSize size, GBitmapFormat format)
+{
+    s_frame.allocations++;
+    return gbitmap_create_blank(size, format);
+}
+
+void render_stats_set_stroke_width(GContext *ctx, uint8_t stroke_width)
+{
+    s_stroke_width = stroke_width;
+    graphics_context_set_stroke_width(ctx, stroke_width);
+}
+
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "utility.h"
+#include <pebble.h>
+
+#ifdef RENDER_STATS
+
+// Drawing work done during one frame of the main window
+typedef struct
+{
+    uint16_t lines;
+    uint16_t path_fills;
+    uint16_t rect_fills;
+    uint16_t bitmaps;
+    uint16_t texts;
+    uint16_t allocations;
+    uint32_t pixels;
+} RenderStats;
+
+void render_stats_frame_begin(void);
+void render_stats_frame_end(ScoreBucket morning, ScoreBucket afternoon);
+// Work counted since the last frame_begin, used by the host benchmark in tools/host
+const RenderStats *render_stats_get_frame(void);
+void render_stats_set_stroke_width(GContext *ctx, uint8_t stroke_width);
+void render_stats_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+void render_stats_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void render_stats_draw_path_filled(GContext *ctx, GPath *path);
+void render_stats_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void render_stats_draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode,
+                            GTextAlignment alignment, GTextAttributes *text_attributes);
+GBitmap *render_stats_create_blank_bitmap(GSize size, GBitmapFormat format);
+
+// Route drawing calls through the counters everywhere except the counters themselves
+#ifndef RENDER_STATS_IMPLEMENTATION
+#define graphics_context_set_stroke_width render_stats_set_stroke_width
+#define graphics_draw_line render_stats_draw_line
+#define graphics_fill_rect render_stats_fill_rect
+#define gpath_draw_filled render_stats_draw_path_filled
+#define graphics_draw_bitmap_in_rect render_stats_draw_bitmap_in_rect
+#define graphics_draw_text render_stats_draw_text
+#define gbitmap_create_blank render_stats_create_blank_bitmap
+#endif
+
+#else
+
+#define render_stats_frame_begin()
+#define render_stats_frame_end(morning, afternoon)
+
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "render_stats.h"
+
+// Upper bounds for one main window frame, generated by tools/host/update_render_baselines.py from the host render
+// benchmark running each platform through every score bucket, do not edit.
+// A frame may cost at most the fixed baseline plus the image baselines of the morning and afternoon buckets.
+// Image baselines cover both the first frame (drawn and captured) and later frames (one cached blit).
+
+#if defined(PBL_PLATFORM_APLITE) || defined(PBL_PLATFORM_BASALT) || defined(PBL_PLATFORM_DIORITE)
+#ifdef UI_SINGLE_LAYER
+static const RenderStats s_frame_baseline = {.rect_fills = 6, .texts = 6, .pixels = 54520};
+#else
+static const RenderStats s_frame_baseline = {.rect_fills = 6, .pixels = 45040};
+#endif
+static const RenderStats s_image_baselines[SCORE_BUCKET_COUNT] = {
+    [SCORE_BUCKET_NOT_VISIBLE] = {.lines = 32, .path_fills = 2, .bitmaps = 1, .allocations = 1, .pixels = 1712},
+    [SCORE_BUCKET_BARELY_VISIBLE] = {.lines = 28, .path_fills = 1, .bitmaps = 1, .allocations = 1, .pixels = 1406},
+    [SCORE_BUCKET_PARTLY_VISIBLE] = {.lines = 28, .path_fills = 1, .bitmaps = 1, .allocations = 1, .pixels = 1406},
+    [SCORE_BUCKET_VISIBLE] = {.lines = 12, .bitmaps = 1, .allocations = 1, .pixels = 1369},
+};
+#elif defined(PBL_PLATFORM_CHALK)
+#ifdef UI_SINGLE_LAYER
+static const RenderStats s_frame_baseline = {.rect_fills = 6, .texts = 6, .pixels = 63576};
+#else
+static const RenderStats s_frame_baseline = {.rect_fills = 6, .pixels = 52520};
+#endif
+static const RenderStats s_image_baselines[SCORE_BUCKET_COUNT] = {
+    [SCORE_BUCKET_NOT_VISIBLE] = {.lines = 32, .path_fills = 2, .bitmaps = 1, .allocations = 1, .pixels = 1140},
+    [SCORE_BUCKET_BARELY_VISIBLE] = {.lines = 28, .path_fills = 1, .bitmaps = 1, .allocations = 1, .pixels = 1221},
+    [SCORE_BUCKET_PARTLY_VISIBLE] = {.lines = 28, .path_fills = 1, .bitmaps = 1, .allocations = 1, .pixels = 1155},
+    [SCORE_BUCKET_VISIBLE] = {.lines = 12, .bitmaps = 1, .allocations = 1, .pixels = 961},
+};
+#elif defined(PBL_PLATFORM_EMERY)
+#ifdef UI_SINGLE_LAYER
+static const RenderStats s_frame_baseline = {.rect_fills = 6, .texts = 6, .pixels = 102735};
+#else
+static const RenderStats s_frame_baseline = {.rect_fills = 6, .pixels = 84771};
+#endif
+static const RenderStats s_image_baselines[SCORE_BUCKET_COUNT] = {
+    [SCORE_BUCKET_NOT_VISIBLE] = {.lines = 32, .path_fills = 2, .bitmaps = 1, .allocations = 1, .pixels = 3306},
+    [SCORE_BUCKET_BARELY_VISIBLE] = {.lines = 28, .path_fills = 1, .bitmaps = 1, .allocations = 1, .pixels = 2420},
+    [SCORE_BUCKET_PARTLY_VISIBLE] = {.lines = 28, .path_fills = 1, .bitmaps = 1, .allocations = 1, .pixels = 2352},
+    [SCORE_BUCKET_VISIBLE] = {.lines = 12, .bitmaps = 1, .allocations = 1, .pixels = 2304},
+};
+#else
+#error "No render baselines for this platform, run make baselines in tools/host"
+#endif
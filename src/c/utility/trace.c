@@ -0,0 +1,53 @@
+#ifdef TRACE
+
+#include "trace.h"
+
+#define TRACE_BUFFER_SIZE 64
+
+typedef struct
+{
+    uint32_t ms;
+    TracePoint point;
+} TraceEntry;
+
+static const char *const s_point_names[TRACE_POINT_COUNT] = {
+    "main", "init_done", "ready_received", "ready_update_sent", "update_sent",
+    "payload_applied", "main_window_shown", "click", "frame_drawn",
+};
+
+// Oldest entries are overwritten once the buffer is full
+static TraceEntry s_entries[TRACE_BUFFER_SIZE];
+static uint16_t s_next;
+static uint16_t s_count;
+
+void trace_mark(TracePoint point)
+{
+    time_t seconds;
+    uint16_t ms;
+    time_ms(&seconds, &ms);
+
+    s_entries[s_next] = (TraceEntry){
+        .ms = (uint32_t)seconds * 1000 + ms,
+        .point = point,
+    };
+    s_next = (s_next + 1) % TRACE_BUFFER_SIZE;
+    if (s_count < TRACE_BUFFER_SIZE)
+        s_count++;
+}
+
+// Logs the buffer oldest first and empties it, timestamps are relative to the oldest entry
+void trace_dump(void)
+{
+    const uint16_t first = (s_next + TRACE_BUFFER_SIZE - s_count) % TRACE_BUFFER_SIZE;
+    const uint32_t start_ms = s_entries[first].ms;
+    for (uint16_t i = 0; i < s_count; i++)
+    {
+        const TraceEntry *entry = &s_entries[(first + i) % TRACE_BUFFER_SIZE];
+        APP_LOG(APP_LOG_LEVEL_INFO, "[Trace] %s %lu", s_point_names[entry->point],
+                (unsigned long)(entry->ms - start_ms));
+    }
+    APP_LOG(APP_LOG_LEVEL_INFO, "[Trace] end");
+    s_count = 0;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <pebble.h>
+
+#ifdef TRACE
+
+// Named points on the startup, round trip and click paths, see tools/trace_summary.py for the phases between them
+typedef enum
+{
+    TRACE_MAIN = 0,
+    TRACE_INIT_DONE,
+    TRACE_READY_RECEIVED,
+    // The update request answering TRACE_READY_RECEIVED, any other is TRACE_UPDATE_SENT
+    TRACE_READY_UPDATE_SENT,
+    TRACE_UPDATE_SENT,
+    TRACE_PAYLOAD_APPLIED,
+    TRACE_MAIN_WINDOW_SHOWN,
+    TRACE_CLICK,
+    TRACE_FRAME_DRAWN,
+    TRACE_POINT_COUNT
+} TracePoint;
+
+void trace_mark(TracePoint point);
+void trace_dump(void);
+
+#else
+
+#define trace_mark(point)
+#define trace_dump()
+
+#endif
@@ -1,15 +1,38 @@
 #include "utility.h"
 #include "graphics.h"
 
-char *get_score_text(int8_t score)
+ScoreBucket get_score_bucket(int8_t score)
 {
     if (score >= 8)
-        return "Visible";
+        return SCORE_BUCKET_VISIBLE;
     if (score >= 6)
-        return "Partly\nVisible";
+        return SCORE_BUCKET_PARTLY_VISIBLE;
     if (score >= 3)
+        return SCORE_BUCKET_BARELY_VISIBLE;
+    return SCORE_BUCKET_NOT_VISIBLE;
+}
+
+char *get_score_bucket_text(ScoreBucket bucket)
+{
+    switch (bucket)
+    {
+    case SCORE_BUCKET_VISIBLE:
+        return "Visible";
+    case SCORE_BUCKET_PARTLY_VISIBLE:
+        return "Partly\nVisible";
+    case SCORE_BUCKET_BARELY_VISIBLE:
         return "Barely\nVisible";
-    return "Not\nVisible";
+    default:
+        return "Not\nVisible";
+    }
+}
+
+// Scores below 0 mark a period without data
+char *get_score_text(int8_t score)
+{
+    if (score < 0)
+        return "No\nData";
+    return get_score_bucket_text(get_score_bucket(score));
 }
 
 GColor get_score_bubble_color(int8_t score)
@@ -17,12 +40,16 @@ GColor get_score_bubble_color(int8_t score)
 #ifdef PBL_BW
     return GColorWhite;
 #else
-    if (score >= 8)
+    switch (get_score_bucket(score))
+    {
+    case SCORE_BUCKET_VISIBLE:
         return SCORE_VISIBLE_BUBBLE_COLOR;
-    if (score >= 6)
+    case SCORE_BUCKET_PARTLY_VISIBLE:
         return SCORE_PARTLY_VISIBLE_BUBBLE_COLOR;
-    if (score >= 3)
+    case SCORE_BUCKET_BARELY_VISIBLE:
         return SCORE_BARELY_VISIBLE_BUBBLE_COLOR;
-    return SCORE_NOT_VISIBLE_BUBBLE_COLOR;
+    default:
+        return SCORE_NOT_VISIBLE_BUBBLE_COLOR;
+    }
 #endif
 }
@@ -2,5 +2,16 @@
 
 #include <pebble.h>
 
+typedef enum
+{
+    SCORE_BUCKET_NOT_VISIBLE = 0,
+    SCORE_BUCKET_BARELY_VISIBLE = 1,
+    SCORE_BUCKET_PARTLY_VISIBLE = 2,
+    SCORE_BUCKET_VISIBLE = 3,
+    SCORE_BUCKET_COUNT = 4
+} ScoreBucket;
+
+ScoreBucket get_score_bucket(int8_t score);
+char *get_score_bucket_text(ScoreBucket bucket);
 char *get_score_text(int8_t score);
-GColor get_score_bubble_color(int8_t score);
\ No newline at end of file
+GColor get_score_bubble_color(int8_t score);
@@ -0,0 +1,54 @@
+#include "visibility_score.h"
+
+// Port of src/pkjs/scoring.js, kept to the same fixed point so both score every hour identically, which
+// tools/host/scoring_parity.js checks. Factors are in thousandths, so a product reaches 100 * 1000^3 = 1e11.
+#define ONE 1000
+#define WEATHER_CODE_COUNT 100
+// Heavy rain threshold
+#define MAX_PRECIPITATION_HUNDREDTHS 500
+#define ROUNDING 5000000000LL
+#define SCALE 10000000000LL
+
+static uint16_t get_weather_code_penalty(uint8_t code)
+{
+    if (code >= WEATHER_CODE_COUNT)
+        return ONE;
+    // Fog and heavy precipitation hide Fuji whatever the clouds do
+    if ((code >= 45 && code <= 48) || code == 65 || code == 67 || code == 75 || code == 77 || code == 95 ||
+        code == 96 || code == 99)
+        return 0;
+    if (code >= 51 && code <= 67)
+        return 600;
+    if (code == 3)
+        return 400;
+    return ONE;
+}
+
+// Scores each hour 0 when Fuji is hidden and otherwise 1 to 10, dampening is in thousandths for the region
+void score_visibility(const VisibilityColumns *columns, int16_t dampening, uint8_t *scores, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        const uint16_t weather_penalty = get_weather_code_penalty(columns->weather_code[i]);
+        if (weather_penalty == 0 || columns->precipitation[i] > MAX_PRECIPITATION_HUNDREDTHS)
+        {
+            scores[i] = 0;
+            continue;
+        }
+
+        // Atmospheric haze
+        const uint8_t humidity = columns->relative_humidity[i];
+        const int64_t humidity_penalty = humidity > 80 ? 300 : humidity > 60 ? 700 : ONE;
+
+        // Cloud cover is only ever reported up to 100, anything more clamps to the lowest score like in JS
+        const int64_t clear_sky = 100 - (int64_t)columns->cloud_cover_low[i];
+        const int64_t product = clear_sky * humidity_penalty * weather_penalty * dampening;
+        if (product + ROUNDING < SCALE)
+        {
+            scores[i] = 1;
+            continue;
+        }
+        const int64_t score = (product + ROUNDING) / SCALE;
+        scores[i] = score > 10 ? 10 : (uint8_t)score;
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// Plain integer types only, so the engine also builds on Linux for tools/host
+#include <stdint.h>
+
+// Hourly weather in the units Open-Meteo reports, one entry per hour in every column
+typedef struct
+{
+    // Cloud cover at low altitude, percent
+    const uint8_t *cloud_cover_low;
+    // Relative humidity at 2 m, percent
+    const uint8_t *relative_humidity;
+    // WMO weather code
+    const uint8_t *weather_code;
+    // Precipitation in hundredths of a millimetre
+    const uint16_t *precipitation;
+} VisibilityColumns;
+
+void score_visibility(const VisibilityColumns *columns, int16_t dampening, uint8_t *scores, uint16_t count);
@@ -1,74 +1,186 @@
 /**
- * Arbitrary dampening factor to account for different atmospheric regions
+ * Regions Mount Fuji is watched from, shared with the watch which knows each region by its position in this table
+ * @typedef {Object} Region
+ * @property {string} id Identifier of the region, also used for the C enum name
+ * @property {string} name Short name shown on the watch
+ * @property {number} dampening Arbitrary dampening factor to account for different atmospheric regions
+ * @property {Array<{lat: number, long: number, distanceKm: number}>} points Observation points, each region has 3:
+ * 1. Observer location (starting point)
+ * 2. Mid-point
+ * 3. Approach point towards Mount Fuji
+ * @type {Array<Region>}
+ */
+const regions = require('./regions.json')
+const { scoreVisibility, toFixedDampening } = require('./scoring.js')
+
+/**
+ * First hour of each time period in Japan time, each period lasting six hours
  */
-const regionScoreDampening = {
-    north: 1.0,
-    south: 0.75,
+const periodStartHours = {
+    morning: 6,
+    afternoon: 12,
 }
+const periodHours = 6
 
 /**
- * Geographic coordinates for observing Mount Fuji from different regions
- * @typedef {Object} RegionCoords
- * @property {Array<{lat: number, long: number, distanceKm: number}>} north Coordinates for northern observation points
- * @property {Array<{lat: number, long: number, distanceKm: number}>} south Coordinates for southern observation points
- * Each array contains 3 points:
- * 1. Observer location (starting point)
- * 2. Mid-point
- * 3. Approach point towards Mount Fuji
+ * AppMessage protocol spoken with the watch, see src/c/app/protocol.h
  */
-const regionCoords = {
-    north: [
-        { lat: 35.5, long: 138.75, distanceKm: 0 }, // Observer location
-        { lat: 35.45, long: 138.75, distanceKm: 5.55 }, // Mid-point
-        { lat: 35.4, long: 138.75, distanceKm: 11.09 }, // Approach
-    ],
-    south: [
-        { lat: 35.2, long: 138.6875, distanceKm: 0 }, // Observer location
-        { lat: 35.25, long: 138.6875, distanceKm: 5.55 }, // Mid-point
-        { lat: 35.3, long: 138.75, distanceKm: 12.47 } // Approach
-    ]
-}
-
-/**
- * Object representing visibility scores and weights for different regions and times of day.
- */
-const regionScores = {
-    north: {
-        morning: {
-            score: 0, weight: 0
-        },
-        afternoon: {
-            score: 0, weight: 0
-        }
-    },
-    south: {
-        morning: {
-            score: 0, weight: 0
-        },
-        afternoon: {
-            score: 0, weight: 0
-        }
-    }
+const protocolVersion = 5
+const opcodes = {
+    ready: 1,
+    updateAll: 2,
+    timeline: 4,
+    resync: 5,
+    chunk: 6,
 }
+const syncFlags = {
+    reset: 0x1,
+    stale: 0x2,
+    complete: 0x4,
+    fetchFirst: 0x8,
+}
+const timePeriods = ['morning', 'afternoon']
+const unknownScore = 0xF
 
 /**
- * Generates a URL for the Open-Meteo API with weather forecast parameters
- * @param {Object} params - The parameters object
- * @param {number} params.lat - The latitude coordinate
- * @param {number} params.long - The longitude coordinate
- * @param {('morning'|'afternoon')} params.time - The time of day to get forecast for
- * @returns {string} The complete URL for the Open-Meteo API request
+ * Bytes at the start of every chunk after the protocol version: transfer id, then big endian chunk index,
+ * chunk count and total length
+ */
+const chunkHeaderBytes = 7
+
+/**
+ * Sync state reported by the watch with its last update request
+ */
+const watchSync = { sequence: 0, stale: false, fetchFirst: false, inboxSize: 128 }
+let transferId = 0
+let resyncRequested = false
+let syncing = false
+/**
+ * Stats of a sync asked for while another was in progress, which runs once that one ends
+ * @type {?Object}
+ */
+let queuedSyncStats = null
+let fetching = false
+/**
+ * When the forecast behind the current scores was fetched, in seconds since the epoch, the oldest of its points.
+ * The last message of each sync tells the watch, whose background launches go by it.
+ */
+let forecastFetchedAt = 0
+/**
+ * The day in Japan the current scores are for, as YYYY-MM-DD
+ */
+let forecastDate = ''
+
+/**
+ * Limits for forecast requests: requests in flight at once, points asked for per request, how long a request may
+ * take and how often it is tried before its points are given up on
+ */
+const requestPool = {
+    maxConcurrent: 2,
+    pointsPerRequest: 20,
+    timeoutMs: 10000,
+    maxAttempts: 3,
+    retryBaseMs: 1000,
+}
+
+/**
+ * Where forecasts are requested from. Setting apiBaseUrl in local storage points the app at a stand-in for
+ * Open-Meteo, so the refresh path can be measured offline.
+ */
+const defaultApiBaseUrl = 'https://api.open-meteo.com/v1/forecast'
+
+/**
+ * Sampling along the line of sight from each observer to the summit. With samples above zero, set for a phone
+ * with lineOfSightSamples in local storage, each region is sampled at that many points spread evenly along the
+ * great circle from its observer to the summit instead of at its hand-picked points. More samples give a better
+ * picture of the air in between at the cost of more requests and scoring. Larger settings are clamped to
+ * maxSamples: ten points per region already resolve the cloud along a line of sight tens of kilometres long, and
+ * each sample adds a point per region to every request, to the cached forecasts and to the point tables below.
+ */
+const lineOfSight = {
+    summit: { lat: 35.3606, long: 138.7274 },
+    samples: 0,
+    maxSamples: 10,
+    decayPerKm: 0.1,
+}
+const earthRadiusKm = 6371
+
+/**
+ * Points to fetch for each sample count, built once with their distance weights
+ * @type {Object<number, Array<{region: number, point: {lat: number, long: number, distanceKm: number}, weight: number}>>}
+ */
+const requestedPointTables = {}
+
+/**
+ * Timeline pins for the hours Fuji is expected to be visible. The pins sent for today are remembered, so only
+ * windows that changed are sent again and windows that went away are taken down.
+ */
+const timelinePins = {
+    apiBaseUrl: 'https://timeline-api.rebble.io/v1/user/pins/',
+    key: 'pins',
+    minScore: 8,
+}
+
+/**
+ * Each refresh gets a new generation, requests of an older generation are aborted and their results dropped
+ */
+let refreshGeneration = 0
+const activeRequests = []
+
+/**
+ * Creates empty per-hour score accumulators for a time period
+ * @returns {{hourly: Array<{score: number, weight: number}>, done: boolean}}
+ */
+function createPeriodScores() {
+    return { hourly: [], done: false }
+}
+
+/**
+ * Dampening of each region in the fixed point the scoring engine works in, indexed by region id
+ */
+const dampenings = regions.map(({ dampening }) => toFixedDampening(dampening))
+
+/**
+ * Weighted hourly visibility scores for each time of day, indexed by region id
+ */
+const regionScores = regions.map(() => ({
+    morning: createPeriodScores(),
+    afternoon: createPeriodScores()
+}))
+
+/**
+ * Forecasts cached per forecast date and coordinate. Cached forecasts are served for up to maxAgeMs, and fetched
+ * again in the background once older than revalidateAgeMs.
+ */
+const forecastCache = {
+    key: 'forecast',
+    maxAgeMs: 6 * 60 * 60 * 1000,
+    revalidateAgeMs: 60 * 60 * 1000,
+}
+
+/**
+ * @returns {string} Today's date in Japan time, which the forecast periods are defined in
  */
-function getUrl({ lat, long, time }) {
+function getForecastDate() {
     const now = new Date()
     now.setHours(now.getHours() + 9)
-    const today = now.toISOString().split('T')[0]
-    const hourRange = time === 'morning'
-        ? { start: `${today}T06:00`, end: `${today}T11:00` }
-        : { start: `${today}T12:00`, end: `${today}T17:00` }
-    return `https://api.open-meteo.com/v1/forecast?` +
-        `latitude=${lat}` +
-        `&longitude=${long}` +
+    return now.toISOString().split('T')[0]
+}
+
+/**
+ * Generates a URL for the Open-Meteo API asking for every time period at once
+ * @param {Array<{lat: number, long: number}>} points - The coordinates to get forecasts for
+ * @param {string} today - The forecast date
+ * @returns {string} The complete URL for the Open-Meteo API request
+ */
+function getUrl(points, today) {
+    const hourRange = {
+        start: `${today}T${String(periodStartHours.morning).padStart(2, '0')}:00`,
+        end: `${today}T${String(periodStartHours.afternoon + periodHours - 1).padStart(2, '0')}:00`
+    }
+    return `${localStorage.getItem('apiBaseUrl') || defaultApiBaseUrl}?` +
+        `latitude=${points.map(({ lat }) => lat).join(',')}` +
+        `&longitude=${points.map(({ long }) => long).join(',')}` +
         `&hourly=cloud_cover_low,precipitation,weather_code,relative_humidity_2m` +
         `&timezone=Asia/Tokyo` +
         `&start_hour=${hourRange.start}` +
@@ -76,199 +188,748 @@ function getUrl({ lat, long, time }) {
 }
 
 /**
- * Calculates a visibility score (0-10) for Mt. Fuji based on weather conditions.
- * @param {Object} params - Weather condition parameters
- * @param {number} params.cloudCoverLow - Cloud cover percentage at low altitude (0-100)
- * @param {number} params.relativeHumidity - Relative humidity percentage (0-100)
- * @param {number} params.weatherCode - WMO weather code
- * @param {number} params.precipitation - Precipitation amount in mm
- * @param {'north'|'south'} params.region - Region from which Fuji is being viewed
- * @returns {number} Visibility score from 1 (not visible) to 10 (perfect visibility)
+ * @returns {number} Points sampled per region along the line of sight, 0 for the hand-picked points, at most
+ *     lineOfSight.maxSamples
+ */
+function getLineOfSightSamples() {
+    const samples = parseInt(localStorage.getItem('lineOfSightSamples'), 10)
+    return samples >= 0 ? Math.min(samples, lineOfSight.maxSamples) : lineOfSight.samples
+}
+
+/**
+ * Finds the point a fraction of the way along the great circle between two points
+ * @param {{lat: number, long: number}} from - Start of the path
+ * @param {{lat: number, long: number}} to - End of the path
+ * @param {number} fraction - How far along the path, from 0 to 1
+ * @returns {{lat: number, long: number, distanceKm: number}} The point, with its distance from the start
  */
-function calculateVisibilityScore({
-    cloudCoverLow,
-    relativeHumidity,
-    weatherCode,
-    precipitation,
-    region
-}) {
-    // Immediate disqualifiers
-    if (weatherCode >= 45 && weatherCode <= 48) return 0 // Fog
-    if ([65, 67, 75, 77, 95, 96, 99].includes(weatherCode)) return 0 // Heavy precipitation
-    if (precipitation > 5.0) return 0 // Heavy rain threshold
+function getGreatCirclePoint(from, to, fraction) {
+    const toRadians = degrees => degrees * Math.PI / 180
+    const toDegrees = radians => radians * 180 / Math.PI
+    const lat1 = toRadians(from.lat)
+    const long1 = toRadians(from.long)
+    const lat2 = toRadians(to.lat)
+    const long2 = toRadians(to.long)
 
-    // Base score from cloud cover
-    let score = 10 * (1 - cloudCoverLow / 100)
+    // Angular distance between the ends by the haversine formula
+    const a = Math.pow(Math.sin((lat2 - lat1) / 2), 2) +
+        Math.cos(lat1) * Math.cos(lat2) * Math.pow(Math.sin((long2 - long1) / 2), 2)
+    const angle = 2 * Math.atan2(Math.sqrt(a), Math.sqrt(1 - a))
+    if (angle === 0) return { lat: from.lat, long: from.long, distanceKm: 0 }
 
-    // Humidity penalty (atmospheric haze)
-    const humidityPenalty =
-        relativeHumidity > 80 ? 0.3 :
-            relativeHumidity > 60 ? 0.7 : 1.0
-    score *= humidityPenalty
+    const weightFrom = Math.sin((1 - fraction) * angle) / Math.sin(angle)
+    const weightTo = Math.sin(fraction * angle) / Math.sin(angle)
+    const x = weightFrom * Math.cos(lat1) * Math.cos(long1) + weightTo * Math.cos(lat2) * Math.cos(long2)
+    const y = weightFrom * Math.cos(lat1) * Math.sin(long1) + weightTo * Math.cos(lat2) * Math.sin(long2)
+    const z = weightFrom * Math.sin(lat1) + weightTo * Math.sin(lat2)
 
-    // Weather code penalties
-    if (weatherCode === 3) score *= 0.4 // Overcast
-    else if (weatherCode >= 51 && weatherCode <= 67) score *= 0.6 // Any precipitation
+    // Rounded to about ten metres so the coordinates, and the cache keys made from them, stay stable
+    const round = value => Math.round(value * 10000) / 10000
+    return {
+        lat: round(toDegrees(Math.atan2(z, Math.sqrt(x * x + y * y)))),
+        long: round(toDegrees(Math.atan2(y, x))),
+        distanceKm: round(fraction * angle * earthRadiusKm),
+    }
+}
 
-    // Dampening factor for different regions
-    score = score * regionScoreDampening[region || 'north']
+/**
+ * Lists the points to fetch for every region, each with its distance weight computed up front. Forecasts come
+ * back in the same order, so a forecast belongs to the point at its index.
+ * @param {number} samples - Points per region along the line of sight, 0 for the hand-picked points
+ * @returns {Array<{region: number, point: {lat: number, long: number, distanceKm: number}, weight: number}>}
+ */
+function getRequestedPoints(samples) {
+    if (requestedPointTables[samples]) return requestedPointTables[samples]
 
-    return Math.round(Math.max(1, Math.min(10, score)))
+    const requestedPoints = []
+    regions.forEach(({ points }, region) => {
+        // The observer is the first hand-picked point, the last sample is the summit itself
+        const regionPoints = samples > 0
+            ? Array.from({ length: samples }, (_, i) =>
+                getGreatCirclePoint(points[0], lineOfSight.summit, samples > 1 ? i / (samples - 1) : 0))
+            : points
+        regionPoints.forEach(point => requestedPoints.push({
+            region,
+            point,
+            weight: Math.exp(-lineOfSight.decayPerKm * point.distanceKm),
+        }))
+    })
+    requestedPointTables[samples] = requestedPoints
+    return requestedPoints
 }
 
 /**
- * Handles the response from a weather data request and calculates visibility scores
- * @param {Object} params - The parameters object
- * @param {'north'|'south'} params.region - The geographical region to calculate scores for
- * @param {'morning'|'afternoon'} params.time - The time period for the calculation
- * @this {XMLHttpRequest} - The XHR context containing the response data
+ * Calculates visibility scores from one forecast per observation point
+ * @param {Array<{region: number, point: {lat: number, long: number}, weight: number}>} requestedPoints - The
+ * observation points the forecasts belong to
+ * @param {Array<{hourly: Object}>} forecasts - Open-Meteo forecasts, in the same order as the points
  * @description This function:
- * 1. Parses weather data response
- * 2. Calculates hourly visibility scores
- * 3. Applies distance-based weighting
- * 4. Updates regional scores
- * 5. Posts final weighted score to Pebble device
- */
-function requestOnLoad({ region, time }) {
-    if (this.status >= 200 && this.status < 400) {
-        const response = JSON.parse(this.response)
-        console.log('[PebbleKit JS]: Received valid response')
-        const { latitude, longitude } = response
-        const currentRegion = regionCoords[region].find(regionCoord => regionCoord.lat === latitude && regionCoord.long === longitude)
-
-        // Calculate the average score for a time span per point of a region
-        const { hourly: hourlyWeather } = response
-        let hourlyAverageScore = -1
-        for (let i = 0; i < hourlyWeather.time.length; i++) {
-            const relativeHumidity = hourlyWeather.relative_humidity_2m[i]
-            const precipitation = hourlyWeather.precipitation[i]
-            const cloudCoverLow = hourlyWeather.cloud_cover_low[i]
-            const weatherCode = hourlyWeather.weather_code[i]
-
-            let visibilityScore = calculateVisibilityScore({
-                cloudCoverLow,
-                relativeHumidity,
-                weatherCode,
-                precipitation,
-                region
-            })
+ * 1. Calculates the visibility score of every hour of a forecast in one batch
+ * 2. Splits the hours into the time periods
+ * 3. Applies the distance-based weight of the point
+ * 4. Adds each hour to the regional hourly scores
+ */
+function calculateRegionScores(requestedPoints, forecasts) {
+    regionScores.forEach(periodScores => {
+        timePeriods.forEach(time => {
+            periodScores[time] = createPeriodScores()
+        })
+    })
 
-            if (hourlyAverageScore === -1) {
-                hourlyAverageScore = visibilityScore
-            } else {
-                hourlyAverageScore = (hourlyAverageScore + visibilityScore) / 2
+    forecasts.forEach(({ hourly: hourlyWeather }, forecastIndex) => {
+        const { region, weight } = requestedPoints[forecastIndex]
+
+        const visibilityScores = new Uint8Array(hourlyWeather.time.length)
+        scoreVisibility({
+            cloudCoverLow: hourlyWeather.cloud_cover_low,
+            relativeHumidity: hourlyWeather.relative_humidity_2m,
+            weatherCode: hourlyWeather.weather_code,
+            precipitation: hourlyWeather.precipitation
+        }, dampenings[region], visibilityScores)
+
+        timePeriods.forEach(time => {
+            const { hourly } = regionScores[region][time]
+            const firstHour = periodStartHours[time] - periodStartHours.morning
+
+            // Accumulate the score of each hour across the points of a region
+            for (let i = 0; i < periodHours && firstHour + i < visibilityScores.length; i++) {
+                const visibilityScore = visibilityScores[firstHour + i]
+                const { score: currentScore, weight: currentWeight } = hourly[i] || { score: 0, weight: 0 }
+                hourly[i] = {
+                    score: currentScore + visibilityScore * weight,
+                    weight: currentWeight + weight
+                }
+            }
+        })
+    })
+
+    regionScores.forEach(periodScores => {
+        timePeriods.forEach(time => {
+            periodScores[time].done = true
+        })
+    })
+}
+
+/**
+ * Reads the cached forecasts of a day, forecasts of other days are dropped when a new day is cached
+ * @param {string} today - The forecast date
+ * @returns {Object<string, {fetchedAt: number, hourly: Object}>} Forecasts keyed by coordinate
+ */
+function loadCachedForecasts(today) {
+    try {
+        const cached = JSON.parse(localStorage.getItem(forecastCache.key))
+        return cached && cached.date === today ? cached.forecasts : {}
+    } catch (e) {
+        return {}
+    }
+}
+
+function getCoordinateKey({ lat, long }) {
+    return `${lat},${long}`
+}
+
+/**
+ * Caches freshly fetched forecasts
+ * @param {Array<{point: {lat: number, long: number}}>} requestedPoints - The points the forecasts belong to
+ * @param {Array<{hourly: Object}>} forecasts - Open-Meteo forecasts, in the same order as the points
+ * @param {string} today - The forecast date
+ */
+function saveCachedForecasts(requestedPoints, forecasts, today) {
+    const cachedForecasts = loadCachedForecasts(today)
+    const fetchedAt = Date.now()
+    forecasts.forEach(({ hourly }, forecastIndex) => {
+        cachedForecasts[getCoordinateKey(requestedPoints[forecastIndex].point)] = { fetchedAt, hourly }
+    })
+    localStorage.setItem(forecastCache.key, JSON.stringify({ date: today, forecasts: cachedForecasts }))
+}
+
+/**
+ * Calculates the weighted score of each hour of a time period across all points of a region
+ * @param {{hourly: Array<{score: number, weight: number}>}} periodScores - Accumulated scores of the period
+ * @returns {Array<number>} Score from 0 to 10 per hour
+ */
+function calculateHourlyScores({ hourly }) {
+    return hourly.map(({ score, weight }) => Math.round(score / weight))
+}
+
+/**
+ * Converts a score into a protocol byte, scores that could not be calculated are sent as unknown
+ * @param {number} score - Score from 0 to 10
+ * @returns {number} The score, or the unknown marker
+ */
+function encodeScore(score) {
+    return Number.isInteger(score) && score >= 0 && score <= 10 ? score : unknownScore
+}
+
+/**
+ * Sequence numbers skip 0, which stands for a watch that has nothing to build on
+ * @param {number} sequence - The last sequence number
+ * @returns {number} The sequence number after it
+ */
+function getNextSequence(sequence) {
+    return sequence >= 0xFFFF ? 1 : sequence + 1
+}
+
+/**
+ * Creates a snapshot of what the watch has acknowledged
+ * @param {number} sequence - Sequence number of the last acknowledged update
+ * @param {string} date - The forecast date the snapshot's scores are for
+ * @returns {{sequence: number, date: string, timelines: Object<number, Array<number>>, fetchedAt: number}}
+ */
+function createSnapshot(sequence, date) {
+    return { sequence, date, timelines: {}, fetchedAt: 0 }
+}
+
+/**
+ * The snapshot is kept per watch, so a phone paired with another watch starts over
+ * @returns {string} Local storage key of the snapshot for the connected watch
+ */
+function getSnapshotKey() {
+    return 'snapshot:' + Pebble.getWatchToken()
+}
+
+function loadSnapshot() {
+    try {
+        return JSON.parse(localStorage.getItem(getSnapshotKey())) || createSnapshot(0, '')
+    } catch (e) {
+        return createSnapshot(0, '')
+    }
+}
+
+function saveSnapshot(snapshot) {
+    localStorage.setItem(getSnapshotKey(), JSON.stringify(snapshot))
+}
+
+/**
+ * Largest payload that fits the watch inbox next to the opcode, one byte for the tuple count
+ * and seven bytes of header per tuple
+ * @returns {number} Payload bytes per message
+ */
+function getMaxPayloadBytes() {
+    return watchSync.inboxSize - 1 - (7 + 4) - 7
+}
+
+/**
+ * Builds the message with the hourly scores of both time periods of each region, the watch derives the period
+ * scores from them
+ * @param {Array<{region: number, hours: Array<number>}>} timelines - Encoded hourly scores starting in the morning
+ * @returns {{op: number, body: Array<number>, apply: function(Object): void}}
+ */
+function createTimelineMessage(timelines) {
+    const body = []
+    timelines.forEach(({ region, hours }) => {
+        body.push(region, 0, periodStartHours.morning, hours.length, ...hours)
+    })
+    return {
+        op: opcodes.timeline,
+        body,
+        apply: snapshot => timelines.forEach(({ region, hours }) => {
+            snapshot.timelines[region] = hours
+        })
+    }
+}
+
+/**
+ * Streams a payload too large for the watch inbox as numbered chunks. All chunks are queued at once so the next one
+ * is on its way while the watch copies the last, and the watch only applies the payload once it has every chunk.
+ * @param {number} op - Opcode of the payload
+ * @param {Array<number>} payload - Payload bytes starting with the protocol header
+ * @param {Object} stats - Refresh stats the chunks count towards
+ * @param {function(): void} onSuccess - Called once every chunk was acknowledged
+ * @param {function(): void} onFailure - Called once if any chunk was not
+ */
+function sendTransfer(op, payload, stats, onSuccess, onFailure) {
+    const data = [op].concat(payload)
+    const chunkBytes = getMaxPayloadBytes() - 1 - chunkHeaderBytes
+    const count = Math.ceil(data.length / chunkBytes)
+    const id = transferId = (transferId + 1) & 0xFF
+    let acknowledged = 0
+    let failed = false
+
+    console.log(`[PebbleKit JS]: Streaming ${data.length} bytes in ${count} chunks`)
+    for (let index = 0; index < count; index++) {
+        const header = [protocolVersion, id, index >> 8, index & 0xFF, count >> 8, count & 0xFF,
+            data.length >> 8, data.length & 0xFF]
+        const chunk = header.concat(data.slice(index * chunkBytes, (index + 1) * chunkBytes))
+        countPostedPayload(stats, chunk)
+        Pebble.sendAppMessage({ op: opcodes.chunk, payload: chunk }, function () {
+            if (++acknowledged === count && !failed) onSuccess()
+        }, function () {
+            if (!failed) {
+                failed = true
+                onFailure()
             }
+        })
+    }
+}
+
+/**
+ * Ends the sync in progress, then runs the one asked for meanwhile, if any, whether this one got through or not
+ * @param {Object} stats - Refresh stats of the sync that ended
+ * @param {string} outcome - How it ended
+ */
+function finishSync(stats, outcome) {
+    syncing = false
+    logRefreshStats(stats, outcome)
+    if (queuedSyncStats) {
+        const queued = queuedSyncStats
+        queuedSyncStats = null
+        syncWatch(queued)
+    }
+}
+
+/**
+ * Sends messages one at a time, each with the next sequence number, recording what the watch acknowledged
+ * @param {Array<{op: number, body: Array<number>, apply: function(Object): void}>} messages - Messages to send
+ * @param {Object} snapshot - Snapshot the messages build on
+ * @param {boolean} reset - Whether the first message starts a full resync
+ * @param {Object} stats - Refresh stats the messages count towards
+ */
+function sendSequenced(messages, snapshot, reset, stats) {
+    if (messages.length === 0) {
+        finishSync(stats, 'synced')
+        return
+    }
+
+    const [message, ...rest] = messages
+    const sequence = getNextSequence(snapshot.sequence)
+    // The watch keeps its restored scores marked until the last message of the sync, which says how old they are
+    const complete = rest.length === 0
+    const fetchedAt = forecastFetchedAt
+    const flags = (reset ? syncFlags.reset : 0) | (complete ? syncFlags.complete : 0)
+    const header = [protocolVersion, sequence >> 8, sequence & 0xFF, flags]
+    if (complete) {
+        header.push((fetchedAt >>> 24) & 0xFF, (fetchedAt >>> 16) & 0xFF, (fetchedAt >>> 8) & 0xFF, fetchedAt & 0xFF)
+    }
+    const payload = header.concat(message.body)
+
+    function onSuccess() {
+        snapshot.sequence = sequence
+        message.apply(snapshot)
+        if (complete) snapshot.fetchedAt = fetchedAt
+        saveSnapshot(snapshot)
+        watchSync.sequence = sequence
+        if (rest.length === 0) watchSync.stale = false
+        sendSequenced(rest, snapshot, false, stats)
+    }
+
+    function onFailure() {
+        // The watch asks again with its own sequence number, which tells what it got
+        console.log('[PebbleKit JS]: Message was not acknowledged, stopping sync at ' + snapshot.sequence)
+        finishSync(stats, 'failed')
+    }
+
+    if (payload.length > getMaxPayloadBytes()) {
+        sendTransfer(message.op, payload, stats, onSuccess, onFailure)
+        return
+    }
+
+    const objectToPost = { op: message.op, payload }
+    countPostedPayload(stats, payload)
+    console.log('[PebbleKit JS]: Posting to Pebble: ' + JSON.stringify(objectToPost))
+    Pebble.sendAppMessage(objectToPost, onSuccess, onFailure)
+}
+
+/**
+ * Sends the watch only the scores that changed since its last acknowledged update, or everything when the watch
+ * holds a different update than the phone remembers or the scores are for another day. The watch drops its scores
+ * at midnight, so yesterday's snapshot says nothing about what it has.
+ * @param {Object} stats - Refresh stats the sync counts towards, see createRefreshStats
+ */
+function syncWatch(stats) {
+    if (syncing) {
+        if (queuedSyncStats) logRefreshStats(queuedSyncStats, 'superseded')
+        queuedSyncStats = stats
+        return
+    }
+
+    let snapshot = loadSnapshot()
+    const reset = resyncRequested || watchSync.sequence !== snapshot.sequence || snapshot.date !== forecastDate
+    resyncRequested = false
+    if (reset) {
+        snapshot = createSnapshot(snapshot.sequence, forecastDate)
+    }
+
+    const timelines = []
+    regionScores.forEach(({ morning, afternoon }, region) => {
+        const hours = calculateHourlyScores(morning).concat(calculateHourlyScores(afternoon)).map(encodeScore)
+        if (JSON.stringify(snapshot.timelines[region]) !== JSON.stringify(hours)) {
+            timelines.push({ region, hours })
         }
+    })
 
-        // Weigh the score based on the distance to the observer point
-        const weight = Math.exp(-0.1 * currentRegion.distanceKm)
-        const weightedScore = hourlyAverageScore * weight
-        const { score: currentScore, weight: currentWeight } = regionScores[region][time]
-        regionScores[region][time] = {
-            score: currentScore + weightedScore,
-            weight: currentWeight + weight
+    const messages = []
+    if (timelines.length > 0) messages.push(createTimelineMessage(timelines))
+    if (messages.length === 0) {
+        if (!watchSync.stale && snapshot.fetchedAt >= forecastFetchedAt) {
+            console.log('[PebbleKit JS]: Forecast unchanged, nothing to send')
+            logRefreshStats(stats, 'unchanged')
+            return
         }
-    } else {
-        console.log('[PebbleKit JS]: Received bad response')
+        // An empty update confirms the scores the watch restored from storage, or that a newer fetch agreed
+        messages.push({ op: opcodes.timeline, body: [], apply: () => { } })
     }
+
+    syncing = true
+    sendSequenced(messages, snapshot, reset, stats)
 }
 
-function calculateWeightedScore({ score, weight }) {
-    return weightedScore = Math.round(score / weight)
+/**
+ * Starts measuring one refresh. Each sync gets its own record, so serving the cache and the fetch that revalidates
+ * it in the background are logged apart.
+ * @param {string} kind - What started the refresh: update, revalidation or resync
+ * @returns {{kind: string, startedAt: number, requests: number, bytesReceived: number, messages: number,
+ *     bytesPosted: number}}
+ */
+function createRefreshStats(kind) {
+    return { kind, startedAt: Date.now(), requests: 0, bytesReceived: 0, messages: 0, bytesPosted: 0 }
 }
 
-function updateAll() {
-    regionScores.north.morning = { score: 0, weight: 0 }
-    regionScores.north.afternoon = { score: 0, weight: 0 }
-    regionScores.south.morning = { score: 0, weight: 0 }
-    regionScores.south.afternoon = { score: 0, weight: 0 }
-    updateSingle({ region: 'north', time: 'morning', waitToPostAll: true })
-    updateSingle({ region: 'north', time: 'afternoon', waitToPostAll: true })
-    updateSingle({ region: 'south', time: 'morning', waitToPostAll: true })
-    updateSingle({ region: 'south', time: 'afternoon', waitToPostAll: true })
+function countPostedPayload(stats, payload) {
+    stats.messages++
+    stats.bytesPosted += payload.length
+}
+
+/**
+ * Logs the wall clock time from the start of a refresh to the watch being up to date, with what it cost
+ * @param {Object} stats - The refresh's stats
+ * @param {string} outcome - How the refresh ended
+ */
+function logRefreshStats(stats, outcome) {
+    const { kind, startedAt, requests, bytesReceived, messages, bytesPosted } = stats
+    console.log(`[PebbleKit JS]: Refresh ${kind} ${outcome} after ${Date.now() - startedAt} ms: ${requests} ` +
+        `requests, ${bytesReceived} bytes received, ${messages} messages with ${bytesPosted} payload bytes posted`)
 }
 
-function updateSingle({ region, time, waitToPostAll }) {
+/**
+ * Creates a pin for every run of consecutive hours a region is expected to be visible
+ * @param {string} today - The forecast date
+ * @returns {Array<Object>} Timeline pins, one per window
+ */
+function createVisibilityPins(today) {
+    const pins = []
+    regionScores.forEach((periodScores, region) => {
+        // Hours from the start of the morning, periods without data leave holes
+        const hours = []
+        timePeriods.forEach(time => calculateHourlyScores(periodScores[time]).forEach((score, i) => {
+            hours[periodStartHours[time] - periodStartHours.morning + i] = score
+        }))
+
+        for (let start = 0; start < hours.length; start++) {
+            if (!(hours[start] >= timelinePins.minScore)) continue
+            let end = start
+            while (hours[end + 1] >= timelinePins.minScore) end++
+
+            const startHour = periodStartHours.morning + start
+            const length = end - start + 1
+            pins.push({
+                id: `fuji-${today}-${regions[region].id}-${startHour}`,
+                time: new Date(`${today}T${('0' + startHour).slice(-2)}:00:00+09:00`).toISOString(),
+                duration: length * 60,
+                layout: {
+                    type: 'genericPin',
+                    title: `Fuji visible from ${regions[region].name}`,
+                    subtitle: `${length} h, best ${Math.max(...hours.slice(start, end + 1))}/10`,
+                    tinyIcon: 'system://images/TIMELINE_SUN',
+                },
+            })
+            start = end
+        }
+    })
+    return pins
+}
+
+/**
+ * Sends a pin to the timeline web API, or takes it down
+ * @param {string} method - PUT to send the pin, DELETE to take it down
+ * @param {string} id - Pin id
+ * @param {string} token - The user's timeline token
+ * @param {?string} body - The pin as JSON for PUT
+ * @param {function(): void} onSuccess - Called once the timeline has the change
+ */
+function sendPinRequest(method, id, token, body, onSuccess) {
     const request = new XMLHttpRequest()
-    regionScores[region][time] = { score: 0, weight: 0 }
     request.onload = function () {
-        requestOnLoad.call(this, { region, time })
+        if (this.status >= 200 && this.status < 300) {
+            onSuccess()
+        } else {
+            console.log(`[PebbleKit JS]: Pin ${method} ${id} failed: status ${this.status}`)
+        }
+    }
+    request.onerror = () => console.log(`[PebbleKit JS]: Pin ${method} ${id} failed`)
+    request.open(method, timelinePins.apiBaseUrl + encodeURIComponent(id))
+    request.setRequestHeader('Content-Type', 'application/json')
+    request.setRequestHeader('X-User-Token', token)
+    request.send(body)
+}
+
+/**
+ * Publishes today's visibility windows as timeline pins, so they can be read without opening the app
+ * @param {string} today - The forecast date
+ */
+function publishPins(today) {
+    let published
+    try {
+        published = JSON.parse(localStorage.getItem(timelinePins.key)) || {}
+    } catch (e) {
+        published = {}
     }
+    // Pins of earlier days stay on the timeline as they are
+    const prefix = `fuji-${today}-`
+    Object.keys(published).forEach(id => {
+        if (id.indexOf(prefix) !== 0) delete published[id]
+    })
 
-    // Send one HTTP request at a time per region and time frame
-    function loop(i, length, waitToPostAll) {
-        if (i >= length) {
-            if (waitToPostAll) {
-                if (regionScores.north.morning.score > 0
-                    && regionScores.north.afternoon.score > 0
-                    && regionScores.south.morning.score > 0
-                    && regionScores.south.afternoon.score > 0) {
-                    const { score: northMorningTotalScore, weight: northMorningTotalWeight } = regionScores.north.morning
-                    const northMorningWeightedScore = calculateWeightedScore({ score: northMorningTotalScore, weight: northMorningTotalWeight })
-
-                    const { score: northAfternoonTotalScore, weight: northAfternoonTotalWeight } = regionScores.north.afternoon
-                    const northAfternoonWeightedScore = calculateWeightedScore({ score: northAfternoonTotalScore, weight: northAfternoonTotalWeight })
-
-                    const { score: southMorningTotalScore, weight: southMorningTotalWeight } = regionScores.south.morning
-                    const southMorningWeightedScore = calculateWeightedScore({ score: southMorningTotalScore, weight: southMorningTotalWeight })
-
-                    const { score: southAfternoonTotalScore, weight: southAfternoonTotalWeight } = regionScores.south.afternoon
-                    const southAfternoonWeightedScore = calculateWeightedScore({ score: southAfternoonTotalScore, weight: southAfternoonTotalWeight })
-
-                    const objectToPost = {
-                        type: 'new_scores',
-                        northMorning: northMorningWeightedScore,
-                        northAfternoon: northAfternoonWeightedScore,
-                        southMorning: southMorningWeightedScore,
-                        southAfternoon: southAfternoonWeightedScore
-                    }
-
-                    console.log('[PebbleKit JS]: Posting to Pebble: ' + JSON.stringify(objectToPost))
-                    Pebble.sendAppMessage(objectToPost)
-                }
-            } else {
-                // Calculate the weighted score for all points of a region
-                const { score: totalScore, weight: totalWeight } = regionScores[region][time]
-                const weightedScore = calculateWeightedScore({ score: totalScore, weight: totalWeight })
+    const bodies = {}
+    createVisibilityPins(today).forEach(pin => {
+        bodies[pin.id] = JSON.stringify(pin)
+    })
+    const changed = Object.keys(bodies).filter(id => published[id] !== bodies[id])
+    const removed = Object.keys(published).filter(id => !(id in bodies))
+    if (changed.length === 0 && removed.length === 0) return
 
-                const objectToPost = { type: 'new_score', region, time, score: weightedScore }
-                console.log('[PebbleKit JS]: Posting to Pebble: ' + JSON.stringify(objectToPost))
-                Pebble.sendAppMessage(objectToPost)
-            }
+    const save = () => localStorage.setItem(timelinePins.key, JSON.stringify(published))
+    Pebble.getTimelineToken(token => {
+        changed.forEach(id => sendPinRequest('PUT', id, token, bodies[id], () => {
+            published[id] = bodies[id]
+            save()
+        }))
+        removed.forEach(id => sendPinRequest('DELETE', id, token, null, () => {
+            delete published[id]
+            save()
+        }))
+    }, error => console.log('[PebbleKit JS]: No timeline token: ' + error))
+}
+
+/**
+ * Aborts the requests of the current refresh, a newer refresh supersedes it
+ */
+function cancelRefresh() {
+    refreshGeneration++
+    activeRequests.splice(0).forEach(request => request.abort())
+}
+
+/**
+ * Requests JSON with a timeout, retrying timeouts, network errors and server errors after a jittered backoff
+ * @param {string} url - The URL to request
+ * @param {number} generation - The refresh the request belongs to
+ * @param {Object} stats - Refresh stats every attempt counts towards
+ * @param {function(Object): void} onSuccess - Called with the parsed response
+ * @param {function(string): void} onFailure - Called with the reason once no attempts are left
+ */
+function requestJson(url, generation, stats, onSuccess, onFailure) {
+    function attempt(attemptIndex) {
+        if (generation !== refreshGeneration) {
+            onFailure('cancelled')
             return
+        }
 
+        const request = new XMLHttpRequest()
+        let settled = false
+        activeRequests.push(request)
+        stats.requests++
+
+        function settle(response, reason, retryable) {
+            if (settled) return
+            settled = true
+            clearTimeout(timer)
+            const index = activeRequests.indexOf(request)
+            if (index >= 0) activeRequests.splice(index, 1)
+
+            if (response) {
+                onSuccess(response)
+            } else if (retryable && attemptIndex + 1 < requestPool.maxAttempts && generation === refreshGeneration) {
+                // Jitter keeps retries from many phones from arriving together
+                const delay = requestPool.retryBaseMs * Math.pow(2, attemptIndex) * (0.5 + Math.random())
+                console.log(`[PebbleKit JS]: Request failed (${reason}), retrying in ${Math.round(delay)} ms`)
+                setTimeout(() => attempt(attemptIndex + 1), delay)
+            } else {
+                onFailure(reason)
+            }
         }
-        var url = getUrl({ lat: regionCoords[region][i].lat, long: regionCoords[region][i].long, time })
 
-        request.open("GET", url)
-        request.onreadystatechange = function () {
-            if (this.readyState === XMLHttpRequest.DONE && this.status === 200)
-                loop(i + 1, length, waitToPostAll)
+        const timer = setTimeout(() => {
+            request.abort()
+            settle(null, 'timeout', true)
+        }, requestPool.timeoutMs)
+
+        request.onload = function () {
+            stats.bytesReceived += (this.response || '').length
+            if (this.status >= 200 && this.status < 400) {
+                try {
+                    settle(JSON.parse(this.response), null, false)
+                } catch (e) {
+                    settle(null, 'invalid response', true)
+                }
+            } else {
+                settle(null, 'status ' + this.status, this.status >= 500 || this.status === 429)
+            }
         }
+        request.onerror = function () {
+            settle(null, 'network error', true)
+        }
+        request.open('GET', url)
         request.send()
     }
-    loop(0, regionCoords[region].length, waitToPostAll)
+    attempt(0)
+}
+
+/**
+ * Runs tasks with a bounded number at a time
+ * @param {Array<function(function(): void): void>} tasks - Tasks, each calling its argument once it has settled
+ * @param {function(): void} onDone - Called once every task has settled
+ */
+function runPool(tasks, onDone) {
+    let next = 0
+    let settled = 0
+    if (tasks.length === 0) {
+        onDone()
+        return
+    }
+
+    function startNext() {
+        if (next >= tasks.length) return
+        const task = tasks[next++]
+        task(() => {
+            settled++
+            if (settled === tasks.length) onDone()
+            else startNext()
+        })
+    }
+    for (let i = 0; i < Math.min(requestPool.maxConcurrent, tasks.length); i++) startNext()
+}
+
+/**
+ * Fetches the forecast of every observation point of every region, superseding a refresh still in progress.
+ * Points whose request fails fall back to their cached forecast, or are left out, so a misbehaving upstream
+ * delays the scores by at most the timeouts and retries of one request.
+ * @param {Array<{region: number, point: {lat: number, long: number}, weight: number}>} requestedPoints - The
+ * observation points to fetch
+ * @param {string} today - The forecast date
+ * @param {Object} stats - Refresh stats the fetch and the sync after it count towards
+ */
+function fetchForecasts(requestedPoints, today, stats) {
+    cancelRefresh()
+    const generation = refreshGeneration
+    fetching = true
+
+    const forecasts = new Array(requestedPoints.length)
+    const tasks = []
+    for (let first = 0; first < requestedPoints.length; first += requestPool.pointsPerRequest) {
+        const batch = requestedPoints.slice(first, first + requestPool.pointsPerRequest)
+        tasks.push(done => requestJson(getUrl(batch.map(({ point }) => point), today), generation, stats, response => {
+            console.log('[PebbleKit JS]: Received valid response')
+
+            // A single location comes back as an object, several as an array in request order
+            const batchForecasts = Array.isArray(response) ? response : [response]
+            batchForecasts.forEach((forecast, i) => {
+                forecasts[first + i] = forecast
+            })
+            saveCachedForecasts(batch, batchForecasts, today)
+            done()
+        }, reason => {
+            console.log('[PebbleKit JS]: Giving up on ' + batch.length + ' points: ' + reason)
+            done()
+        }))
+    }
+
+    runPool(tasks, () => {
+        if (generation !== refreshGeneration) {
+            logRefreshStats(stats, 'superseded')
+            return
+        }
+        fetching = false
+
+        const cachedForecasts = loadCachedForecasts(today)
+        const availablePoints = []
+        const availableForecasts = []
+        const fetchTimes = []
+        requestedPoints.forEach((requestedPoint, i) => {
+            const cachedForecast = cachedForecasts[getCoordinateKey(requestedPoint.point)]
+            const forecast = forecasts[i] || cachedForecast
+            if (forecast) {
+                availablePoints.push(requestedPoint)
+                availableForecasts.push(forecast)
+                fetchTimes.push(cachedForecast ? cachedForecast.fetchedAt : Date.now())
+            }
+        })
+        if (availableForecasts.length === 0) {
+            console.log('[PebbleKit JS]: No forecasts available')
+            logRefreshStats(stats, 'failed')
+            return
+        }
+
+        calculateRegionScores(availablePoints, availableForecasts)
+        forecastFetchedAt = Math.floor(Math.min(...fetchTimes) / 1000)
+        forecastDate = today
+        syncWatch(stats)
+        publishPins(today)
+    })
+}
+
+/**
+ * Sends the watch cached scores straight away when the cache covers every point, then fetches again if the cache
+ * is getting old. Delta sync means the fetched scores only reach the watch when they differ. A watch launched in the
+ * background closes after its first sync, so it gets an old cache only after the fetch instead.
+ */
+function updateAll() {
+    const stats = createRefreshStats('update')
+    const requestedPoints = getRequestedPoints(getLineOfSightSamples())
+
+    const today = getForecastDate()
+    const now = Date.now()
+    const cachedForecasts = loadCachedForecasts(today)
+    const cached = requestedPoints.map(({ point }) => cachedForecasts[getCoordinateKey(point)])
+    const usable = cached.every(forecast => forecast && now - forecast.fetchedAt < forecastCache.maxAgeMs)
+    const current = usable && cached.every(forecast => now - forecast.fetchedAt < forecastCache.revalidateAgeMs)
+    if (current || (usable && !watchSync.fetchFirst)) {
+        console.log('[PebbleKit JS]: Serving cached forecast')
+        calculateRegionScores(requestedPoints, cached)
+        forecastFetchedAt = Math.floor(Math.min(...cached.map(forecast => forecast.fetchedAt)) / 1000)
+        forecastDate = today
+        syncWatch(stats)
+        publishPins(today)
+        if (current)
+            return
+        // The watch already has scores, what the background fetch costs is measured on its own
+        fetchForecasts(requestedPoints, today, createRefreshStats('revalidation'))
+        return
+    }
+
+    fetchForecasts(requestedPoints, today, stats)
 }
 
 Pebble.on('ready', function () {
     console.log('[PebbleKit JS]: PKJS is Ready!')
-    Pebble.sendAppMessage({ type: 'ready' })
+    Pebble.sendAppMessage({ op: opcodes.ready })
 })
 
 Pebble.addEventListener('appmessage', function (event) {
     console.log('[PebbleKit JS]: Received message: ' + JSON.stringify(event.payload))
     if (event.payload) {
-        switch (event.payload.type) {
-            case 'ready':
-                console.log('[PebbleKit JS]: C is Ready!')
-                break
-            case 'update_all':
+        const [version, sequenceHigh, sequenceLow, flags, inboxHigh, inboxLow] = event.payload.payload || []
+        if (version !== undefined && version !== protocolVersion) {
+            console.log('[PebbleKit JS]: Unsupported protocol version: ' + version)
+            return
+        }
+
+        switch (event.payload.op) {
+            case opcodes.updateAll:
                 console.log('[PebbleKit JS]: Got an update_all request!')
+                watchSync.sequence = (sequenceHigh << 8) | sequenceLow
+                watchSync.stale = Boolean(flags & syncFlags.stale)
+                watchSync.fetchFirst = Boolean(flags & syncFlags.fetchFirst)
+                watchSync.inboxSize = (inboxHigh << 8) | inboxLow
                 updateAll()
                 break
-            case 'update_single':
-                console.log('[PebbleKit JS]: Got an update_single request!')
-                updateSingle({ region: event.payload.region, time: event.payload.time })
+            case opcodes.resync:
+                console.log('[PebbleKit JS]: Got a resync request!')
+                resyncRequested = true
+                if (fetching) break
+                if (regionScores.every(({ morning, afternoon }) => morning.done && afternoon.done))
+                    syncWatch(createRefreshStats('resync'))
+                else
+                    updateAll()
                 break
         }
     }
@@ -0,0 +1,66 @@
+/**
+ * Batch visibility scoring in fixed point. Every factor is kept in thousandths so the score of an hour is one
+ * integer product, which gives the same result on any platform the engine is ported to, such as the watch port in
+ * src/c/utility/visibility_score.c.
+ */
+
+const one = 1000
+
+/**
+ * Weather code penalty in thousandths, 0 for codes that hide Fuji whatever the clouds do
+ */
+const weatherCodePenalties = (function () {
+    const penalties = new Uint16Array(100).fill(one)
+    penalties[3] = 400 // Overcast
+    for (let code = 51; code <= 67; code++) penalties[code] = 600 // Any precipitation
+    for (let code = 45; code <= 48; code++) penalties[code] = 0 // Fog
+    for (const code of [65, 67, 75, 77, 95, 96, 99]) penalties[code] = 0 // Heavy precipitation
+    return penalties
+})()
+
+/**
+ * Heavy rain threshold in millimetres
+ */
+const maxPrecipitation = 5.0
+
+/**
+ * Converts a dampening factor for the region Fuji is viewed from into the fixed point the engine works in
+ * @param {number} dampening - Dampening factor from 0 to 1
+ * @returns {number} Dampening in thousandths
+ */
+function toFixedDampening(dampening) {
+    return Math.round(dampening * one)
+}
+
+/**
+ * Calculates visibility scores for Mt. Fuji for many hours at once, from columns of hourly weather
+ * @param {Object} columns - Hourly weather, one entry per hour in every column
+ * @param {Array<number>} columns.cloudCoverLow - Cloud cover percentage at low altitude (0-100)
+ * @param {Array<number>} columns.relativeHumidity - Relative humidity percentage (0-100)
+ * @param {Array<number>} columns.weatherCode - WMO weather code
+ * @param {Array<number>} columns.precipitation - Precipitation amount in mm
+ * @param {number} dampening - Dampening in thousandths for the region Fuji is viewed from
+ * @param {Uint8Array} scores - Receives a score per hour, 0 when Fuji is hidden and otherwise 1 to 10
+ */
+function scoreVisibility({ cloudCoverLow, relativeHumidity, weatherCode, precipitation }, dampening, scores) {
+    for (let i = 0; i < scores.length; i++) {
+        const code = weatherCode[i]
+        const weatherPenalty = code >= 0 && code < weatherCodePenalties.length ? weatherCodePenalties[code] : one
+        if (weatherPenalty === 0 || precipitation[i] > maxPrecipitation) {
+            scores[i] = 0
+            continue
+        }
+
+        // Atmospheric haze
+        const humidity = relativeHumidity[i]
+        const humidityPenalty = humidity > 80 ? 300 : humidity > 60 ? 700 : one
+
+        // 10 * (100 - cloud cover) / 100 scaled by three factors in thousandths, rounded half up
+        const clearSky = 100 - Math.round(cloudCoverLow[i])
+        const product = clearSky * humidityPenalty * weatherPenalty * dampening
+        const score = Math.floor((product + 5e9) / 1e10)
+        scores[i] = Math.max(1, Math.min(10, score))
+    }
+}
+
+module.exports = { scoreVisibility, toFixedDampening }
@@ -0,0 +1,243 @@
+/**
+ * Local stand-in for the Open-Meteo forecast API, so the phone side refresh can be measured offline. Answers the
+ * hourly queries src/pkjs/index.js makes with recorded forecasts where it has them and synthetic ones otherwise,
+ * after a configurable latency, and fails a configurable share of requests with a server error or by never
+ * answering. Point the app at it by setting apiBaseUrl in local storage, refresh_harness.js does that itself.
+ *
+ *   node forecast_server.js [--port 8080] [--latency ms] [--error-rate 0-1] [--timeout-rate 0-1] [--seed n]
+ *       [--recorded file]
+ *
+ * A recorded file holds forecasts the way the app caches them in local storage under 'forecast', as
+ * {"forecasts": {"<lat>,<long>": {"hourly": {...}}}}, and is replayed for the requested day.
+ */
+const fs = require('fs')
+const http = require('http')
+
+const hourlyVariables = ['cloud_cover_low', 'precipitation', 'weather_code', 'relative_humidity_2m']
+const hourlyUnits = {
+    time: 'iso8601',
+    cloud_cover_low: '%',
+    precipitation: 'mm',
+    weather_code: 'wmo code',
+    relative_humidity_2m: '%',
+}
+/**
+ * Weather codes synthetic hours are drawn from: clear, partly cloudy, overcast, fog, drizzle and rain
+ */
+const syntheticWeatherCodes = [0, 1, 2, 3, 45, 51, 61, 63]
+
+/**
+ * Seeded xorshift32, so runs with the same seed fail the same requests
+ * @param {number} seed - Any non-zero integer
+ * @returns {function(): number} Uniform numbers from 0 up to 1
+ */
+function createRandom(seed) {
+    let state = (seed >>> 0) || 1
+    return () => {
+        state ^= state << 13
+        state ^= state >>> 17
+        state ^= state << 5
+        return (state >>> 0) / 0x100000000
+    }
+}
+
+/**
+ * Hash of a string, used to give every point and hour its own stable synthetic weather
+ */
+function hashString(text) {
+    let hash = 0x811C9DC5
+    for (let i = 0; i < text.length; i++) {
+        hash = Math.imul(hash ^ text.charCodeAt(i), 0x01000193)
+    }
+    return hash >>> 0
+}
+
+/**
+ * @param {string} start - First hour as YYYY-MM-DDTHH:00
+ * @param {string} end - Last hour, inclusive
+ * @returns {Array<string>} Every hour in between in the same format
+ */
+function getHours(start, end) {
+    const hours = []
+    const last = Date.parse(end + 'Z')
+    for (let time = Date.parse(start + 'Z'); time <= last && hours.length < 24 * 16; time += 3600 * 1000) {
+        hours.push(new Date(time).toISOString().slice(0, 16))
+    }
+    return hours
+}
+
+/**
+ * Weather that varies by point and hour but is the same on every request, so repeated refreshes agree
+ */
+function createSyntheticHourly(lat, long, hours) {
+    const hourly = { time: hours }
+    hourlyVariables.forEach(variable => {
+        hourly[variable] = []
+    })
+    hours.forEach(hour => {
+        const random = createRandom(hashString(`${lat},${long},${hour}`))
+        random()
+        hourly.cloud_cover_low.push(Math.floor(random() * 101))
+        hourly.precipitation.push(random() < 0.8 ? 0 : Math.round(random() * 80) / 10)
+        hourly.weather_code.push(syntheticWeatherCodes[Math.floor(random() * syntheticWeatherCodes.length)])
+        hourly.relative_humidity_2m.push(30 + Math.floor(random() * 71))
+    })
+    return hourly
+}
+
+/**
+ * Replays the hours of a recorded forecast on the requested day, in recorded order
+ */
+function replayHourly(recorded, hours) {
+    const hourly = { time: hours }
+    hourlyVariables.forEach(variable => {
+        const values = recorded[variable] || []
+        hourly[variable] = hours.map((hour, i) => values.length > 0 ? values[i % values.length] : 0)
+    })
+    return hourly
+}
+
+/**
+ * Loads recorded forecasts keyed by coordinate, from the app's cache format
+ * @param {?string} path - The recorded file, none for synthetic forecasts only
+ * @returns {Object<string, Object>} Hourly forecasts keyed by "<lat>,<long>"
+ */
+function loadRecorded(path) {
+    if (!path) return {}
+    const recorded = JSON.parse(fs.readFileSync(path, 'utf8'))
+    const forecasts = recorded.forecasts || recorded
+    const hourly = {}
+    Object.keys(forecasts).forEach(key => {
+        hourly[key] = forecasts[key].hourly
+    })
+    return hourly
+}
+
+/**
+ * Builds the response Open-Meteo gives for a query, one object for a single location and an array otherwise
+ * @param {URLSearchParams} query - The request's query
+ * @param {Object<string, Object>} recorded - Recorded forecasts keyed by coordinate
+ * @returns {?{body: Object, recorded: number}} The response and how many of its locations were recorded, null
+ *     for a query Open-Meteo would reject
+ */
+function createForecastResponse(query, recorded) {
+    const latitudes = (query.get('latitude') || '').split(',').filter(Boolean).map(Number)
+    const longitudes = (query.get('longitude') || '').split(',').filter(Boolean).map(Number)
+    const start = query.get('start_hour')
+    const end = query.get('end_hour')
+    if (latitudes.length === 0 || latitudes.length !== longitudes.length || !start || !end ||
+        latitudes.some(isNaN) || longitudes.some(isNaN)) {
+        return null
+    }
+
+    const hours = getHours(start, end)
+    let recordedCount = 0
+    const locations = latitudes.map((latitude, i) => {
+        const key = `${latitude},${longitudes[i]}`
+        if (recorded[key]) recordedCount++
+        return {
+            latitude,
+            longitude: longitudes[i],
+            generationtime_ms: 0.1,
+            utc_offset_seconds: 9 * 3600,
+            timezone: 'Asia/Tokyo',
+            timezone_abbreviation: 'JST',
+            elevation: 0,
+            location_id: i,
+            hourly_units: hourlyUnits,
+            hourly: recorded[key] ? replayHourly(recorded[key], hours) : createSyntheticHourly(latitude, longitudes[i], hours),
+        }
+    })
+    return { body: locations.length === 1 ? locations[0] : locations, recorded: recordedCount }
+}
+
+/**
+ * Creates the stand-in server, not yet listening
+ * @param {Object} options
+ * @param {number} [options.latencyMs=0] - Delay before each answer
+ * @param {number} [options.errorRate=0] - Share of requests answered with status 500
+ * @param {number} [options.timeoutRate=0] - Share of requests never answered
+ * @param {number} [options.seed=1] - Seed for which requests fail
+ * @param {?string} [options.recorded] - Recorded forecasts, see loadRecorded
+ * @returns {{server: http.Server, stats: {requests: number, errors: number, timeouts: number, locations: number,
+ *     recordedLocations: number, bytesSent: number}}}
+ */
+function createForecastServer(options = {}) {
+    const latencyMs = options.latencyMs || 0
+    const errorRate = options.errorRate || 0
+    const timeoutRate = options.timeoutRate || 0
+    const random = createRandom(options.seed || 1)
+    const recorded = loadRecorded(options.recorded)
+    const stats = { requests: 0, errors: 0, timeouts: 0, locations: 0, recordedLocations: 0, bytesSent: 0 }
+
+    const server = http.createServer((request, response) => {
+        stats.requests++
+        const url = new URL(request.url, 'http://localhost')
+        const roll = random()
+        if (roll < timeoutRate) {
+            // Held open until the client gives up, like an upstream that stalls
+            stats.timeouts++
+            return
+        }
+
+        setTimeout(() => {
+            let status = 200
+            let body
+            const forecast = url.pathname === '/v1/forecast' ? createForecastResponse(url.searchParams, recorded) : null
+            if (roll < timeoutRate + errorRate) {
+                stats.errors++
+                status = 500
+                body = { error: true, reason: 'Synthetic server error' }
+            } else if (!forecast) {
+                status = url.pathname === '/v1/forecast' ? 400 : 404
+                body = { error: true, reason: 'Cannot parse request' }
+            } else {
+                const locations = Array.isArray(forecast.body) ? forecast.body.length : 1
+                stats.locations += locations
+                stats.recordedLocations += forecast.recorded
+                body = forecast.body
+            }
+
+            const text = JSON.stringify(body)
+            stats.bytesSent += Buffer.byteLength(text)
+            response.writeHead(status, { 'Content-Type': 'application/json' })
+            response.end(text)
+        }, latencyMs)
+    })
+    return { server, stats }
+}
+
+function parseArguments(argv) {
+    const options = { port: 8080 }
+    const names = {
+        '--port': 'port',
+        '--latency': 'latencyMs',
+        '--error-rate': 'errorRate',
+        '--timeout-rate': 'timeoutRate',
+        '--seed': 'seed',
+        '--recorded': 'recorded',
+    }
+    for (let i = 0; i < argv.length; i += 2) {
+        const name = names[argv[i]]
+        if (!name || i + 1 >= argv.length) {
+            console.error('Unknown option ' + argv[i])
+            process.exit(2)
+        }
+        options[name] = name === 'recorded' ? argv[i + 1] : Number(argv[i + 1])
+    }
+    return options
+}
+
+if (require.main === module) {
+    const options = parseArguments(process.argv.slice(2))
+    const { server, stats } = createForecastServer(options)
+    server.listen(options.port, () => {
+        console.log(`[ForecastServer] Listening on http://localhost:${options.port}/v1/forecast`)
+    })
+    process.on('SIGINT', () => {
+        console.log('[ForecastServer] ' + JSON.stringify(stats))
+        process.exit(0)
+    })
+}
+
+module.exports = { createForecastServer }
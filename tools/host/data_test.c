@@ -0,0 +1,198 @@
+// Checks the watch's score store, src/c/app/data.c, on the host: how hourly scores are packed, how the timelines
+// follow the day in Japan and how they survive a restart. Prints every failed check and a PASS or FAIL line.
+#include "data.h"
+
+// 2026-10-17 00:00 UTC, 09:00 in Japan
+#define DAY_START_UTC 1792195200
+#define JST_NOON (DAY_START_UTC + 3 * SECONDS_PER_HOUR)
+#define JST_LAST_SECOND (DAY_START_UTC + 15 * SECONDS_PER_HOUR - 1)
+
+static int s_failures;
+
+#define CHECK(condition)                                                                                           \
+    do                                                                                                             \
+    {                                                                                                              \
+        if (!(condition))                                                                                          \
+        {                                                                                                          \
+            printf("[DataTest] %s:%d: %s\n", __func__, __LINE__, #condition);                                      \
+            s_failures++;                                                                                          \
+        }                                                                                                          \
+    } while (0)
+
+// A fresh store on the given date, nothing persisted
+static void start(time_t now)
+{
+    host_set_time(now);
+    host_persist_clear();
+    set_data_sequence(0);
+    data_init();
+}
+
+static void test_packing(void)
+{
+    start(JST_NOON);
+    CHECK(sizeof(RegionTimeline) == TIMELINE_DAYS * HOURS_PER_DAY / 2);
+
+    const uint8_t scores[] = {3, 7, 10};
+    CHECK(set_hourly_scores(REGION_NORTH, 0, 6, scores, 3));
+    CHECK(!set_hourly_scores(REGION_NORTH, 0, 6, scores, 3));
+    CHECK(get_hourly_score(REGION_NORTH, 0, 5) == -1);
+    CHECK(get_hourly_score(REGION_NORTH, 0, 6) == 3);
+    CHECK(get_hourly_score(REGION_NORTH, 0, 7) == 7);
+    CHECK(get_hourly_score(REGION_NORTH, 0, 8) == 10);
+    CHECK(get_hourly_score(REGION_NORTH, 0, 9) == -1);
+    CHECK(get_hourly_score(REGION_SOUTH, 0, 6) == -1);
+
+    // Even hours are the low nibble, as persisted
+    save_region_scores();
+    uint8_t hours[sizeof(RegionTimeline)];
+    CHECK(persist_read_data(PERSIST_KEY_TIMELINES, hours, sizeof(hours)) == (int)sizeof(hours));
+    CHECK(hours[3] == 0x73);
+    CHECK(hours[4] == 0xFA);
+    CHECK(hours[2] == 0xFF);
+
+    // Scores outside 0-10 are stored as unknown, without touching the other hour in the byte
+    const uint8_t invalid[] = {11, 0xFF};
+    CHECK(set_hourly_scores(REGION_NORTH, 0, 6, invalid, 1));
+    CHECK(get_hourly_score(REGION_NORTH, 0, 6) == -1);
+    CHECK(get_hourly_score(REGION_NORTH, 0, 7) == 7);
+    CHECK(set_hourly_scores(REGION_NORTH, 0, 7, invalid + 1, 1));
+    CHECK(get_hourly_score(REGION_NORTH, 0, 7) == -1);
+    CHECK(get_hourly_score(REGION_NORTH, 0, 8) == 10);
+
+    // Nothing is stored past the end of the day or the store
+    CHECK(!set_hourly_scores(REGION_NORTH, 0, HOURS_PER_DAY, scores, 1));
+    CHECK(!set_hourly_scores(REGION_NORTH, TIMELINE_DAYS, 6, scores, 1));
+    CHECK(!set_hourly_scores(REGION_COUNT, 0, 6, scores, 1));
+    CHECK(get_hourly_score(REGION_NORTH, TIMELINE_DAYS, 6) == -1);
+}
+
+static void test_period_scores(void)
+{
+    start(JST_NOON);
+    CHECK(get_region_score(REGION_NORTH, 0, TIME_MORNING) == -1);
+
+    // The rounded mean of the hours with data: (4 + 5) / 2 rounds up to 5
+    const uint8_t morning[] = {4, 0xF, 5};
+    set_hourly_scores(REGION_NORTH, 0, MORNING_START_HOUR, morning, 3);
+    CHECK(get_region_score(REGION_NORTH, 0, TIME_MORNING) == 5);
+    CHECK(get_region_score(REGION_NORTH, 0, TIME_AFTERNOON) == -1);
+
+    // Hours outside the period do not count
+    const uint8_t outside[] = {0, 0};
+    set_hourly_scores(REGION_NORTH, 0, MORNING_START_HOUR - 1, outside, 1);
+    set_hourly_scores(REGION_NORTH, 0, AFTERNOON_START_HOUR + PERIOD_HOURS, outside + 1, 1);
+    CHECK(get_region_score(REGION_NORTH, 0, TIME_MORNING) == 5);
+    CHECK(get_region_score(REGION_NORTH, 0, TIME_AFTERNOON) == -1);
+
+    CHECK(set_region_score(REGION_NORTH, TIME_AFTERNOON, 8));
+    CHECK(!set_region_score(REGION_NORTH, TIME_AFTERNOON, 8));
+    for (uint8_t hour = AFTERNOON_START_HOUR; hour < AFTERNOON_START_HOUR + PERIOD_HOURS; hour++)
+    {
+        CHECK(get_hourly_score(REGION_NORTH, 0, hour) == 8);
+    }
+    set_current_region(REGION_NORTH);
+    CHECK(get_current_region_score(TIME_AFTERNOON) == 8);
+}
+
+// The main window needs a score for the region it opens on, refreshes continue until every region has both
+static void test_loaded(void)
+{
+    start(JST_NOON);
+    set_current_region(REGION_SOUTH);
+    CHECK(get_data_loaded_progress() == 0);
+    CHECK(!is_data_loaded());
+    CHECK(!is_data_complete());
+
+    set_region_score(REGION_NORTH, TIME_MORNING, 6);
+    CHECK(!is_data_loaded());
+    set_region_score(REGION_SOUTH, TIME_AFTERNOON, 2);
+    CHECK(is_data_loaded());
+    CHECK(!is_data_complete());
+
+    for (uint16_t region = 0; region < REGION_COUNT; region++)
+    {
+        set_region_score((Region)region, TIME_MORNING, 6);
+        set_region_score((Region)region, TIME_AFTERNOON, 2);
+    }
+    CHECK(get_data_loaded_progress() == REGION_COUNT * TIME_PERIOD_COUNT);
+    CHECK(is_data_complete());
+
+    set_region_score(REGION_NORTH, TIME_MORNING, -1);
+    CHECK(get_data_loaded_progress() == REGION_COUNT * TIME_PERIOD_COUNT - 1);
+    CHECK(is_data_loaded());
+    CHECK(!is_data_complete());
+}
+
+// The day starts at midnight in Japan, and scores of a day that has passed are never shown
+static void test_day_rollover(void)
+{
+    start(JST_LAST_SECOND);
+    set_current_region(REGION_NORTH);
+    set_region_score(REGION_NORTH, TIME_MORNING, 9);
+    CHECK(get_current_region_score(TIME_MORNING) == 9);
+    CHECK(get_data_loaded_progress() == 1);
+
+    set_data_sequence(7);
+
+    host_set_time(JST_LAST_SECOND + 1);
+    CHECK(get_current_region_score(TIME_MORNING) == -1);
+    CHECK(get_data_loaded_progress() == 0);
+
+    // The first score of the new day does not bring back the old ones, and the phone is asked for a full sync
+    set_region_score(REGION_SOUTH, TIME_MORNING, 4);
+    CHECK(get_data_sequence() == 0);
+    CHECK(get_region_score(REGION_NORTH, 0, TIME_MORNING) == -1);
+    CHECK(get_region_score(REGION_SOUTH, 0, TIME_MORNING) == 4);
+    CHECK(get_data_loaded_progress() == 1);
+}
+
+static void test_persistence(void)
+{
+    start(JST_NOON);
+    const uint8_t scores[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    set_hourly_scores(REGION_ENOSHIMA, 0, 5, scores, 10);
+    set_data_sequence(42);
+    save_region_scores();
+
+    // Restored on the same day, but stale until the phone confirms them
+    set_data_sequence(0);
+    data_init();
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        CHECK(get_hourly_score(REGION_ENOSHIMA, 0, 5 + i) == scores[i]);
+    }
+    CHECK(get_hourly_score(REGION_ENOSHIMA, 0, 4) == -1);
+    CHECK(get_data_sequence() == 42);
+    CHECK(is_data_stale());
+
+    // Restored the next day, the scores are dropped
+    host_set_time(JST_NOON + SECONDS_PER_DAY);
+    data_init();
+    CHECK(get_hourly_score(REGION_ENOSHIMA, 0, 6) == -1);
+    CHECK(get_data_loaded_progress() == 0);
+    CHECK(get_data_sequence() == 0);
+
+    // A store written with another layout is ignored
+    host_set_time(JST_NOON);
+    PersistedScores persisted;
+    CHECK(persist_read_data(PERSIST_KEY_SCORES, &persisted, sizeof(persisted)) == (int)sizeof(persisted));
+    persisted.version--;
+    persist_write_data(PERSIST_KEY_SCORES, &persisted, sizeof(persisted));
+    data_init();
+    CHECK(get_hourly_score(REGION_ENOSHIMA, 0, 6) == -1);
+}
+
+int main(void)
+{
+    test_packing();
+    test_period_scores();
+    test_loaded();
+    test_day_rollover();
+    test_persistence();
+
+    const bool passed = s_failures == 0 && host_error_count() == 0;
+    printf("[DataTest] %s: %d failed checks, %u errors logged\n", passed ? "PASS" : "FAIL", s_failures,
+           (unsigned)host_error_count());
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+#!/usr/bin/env python3
+"""
+Writes the region table header the app includes as regions.auto.h, from src/pkjs/regions.json.
+
+The host builds' counterpart of generate_regions_header in wscript, which the watch build uses, and writes the
+same header. Run by the Makefile as `generate_regions_header.py <regions.json> <header>`.
+"""
+import json
+import sys
+
+
+def main():
+    regions_path, header_path = sys.argv[1], sys.argv[2]
+    with open(regions_path) as regions_file:
+        regions = json.load(regions_file)
+
+    lines = ['// Generated from src/pkjs/regions.json, do not edit',
+             '#pragma once',
+             '',
+             '#define REGION_TABLE(X) \\']
+    for region in regions:
+        lines.append('    X({}, "{}") \\'.format(region['id'].upper(), region['name']))
+    lines.append('')
+
+    with open(header_path, 'w') as header:
+        header.write('\n'.join(lines) + '\n')
+
+
+if __name__ == '__main__':
+    main()
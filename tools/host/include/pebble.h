@@ -0,0 +1,319 @@
+#pragma once
+
+// Stand-in for the Pebble SDK header, so the drawing code builds and runs on Linux. Only what the app's UI uses
+// is declared, see pebble_stub.c for the implementations and the recording graphics context.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Platform shape and colour, set from the PBL_PLATFORM_* define the Makefile passes
+#if defined(PBL_PLATFORM_APLITE) || defined(PBL_PLATFORM_DIORITE)
+#define PBL_RECT
+#define PBL_BW
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_BASALT)
+#define PBL_RECT
+#define PBL_COLOR
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_CHALK)
+#define PBL_ROUND
+#define PBL_COLOR
+#define PBL_DISPLAY_WIDTH 180
+#define PBL_DISPLAY_HEIGHT 180
+#elif defined(PBL_PLATFORM_EMERY)
+#define PBL_RECT
+#define PBL_COLOR
+#define PBL_DISPLAY_WIDTH 200
+#define PBL_DISPLAY_HEIGHT 228
+#else
+#error "Define one of PBL_PLATFORM_APLITE, BASALT, CHALK, DIORITE or EMERY"
+#endif
+
+#ifdef PBL_ROUND
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_true)
+#else
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_false)
+#endif
+#ifdef PBL_COLOR
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+#else
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_false)
+#endif
+#define PBL_API_EXISTS(api) 0
+
+// Logging, errors are counted so a host run can fail on them
+typedef enum
+{
+    APP_LOG_LEVEL_ERROR = 1,
+    APP_LOG_LEVEL_WARNING = 50,
+    APP_LOG_LEVEL_INFO = 100,
+    APP_LOG_LEVEL_DEBUG = 200,
+} AppLogLevel;
+
+void host_app_log(AppLogLevel level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+#define APP_LOG(level, ...) host_app_log(level, __VA_ARGS__)
+
+// Geometry
+typedef struct
+{
+    int16_t x;
+    int16_t y;
+} GPoint;
+
+typedef struct
+{
+    int16_t w;
+    int16_t h;
+} GSize;
+
+typedef struct
+{
+    GPoint origin;
+    GSize size;
+} GRect;
+
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GPointZero GPoint(0, 0)
+
+bool grect_equal(const GRect *rect_a, const GRect *rect_b);
+
+// Colours, only told apart by value
+typedef union
+{
+    uint8_t argb;
+} GColor8;
+typedef GColor8 GColor;
+
+static inline bool gcolor_equal(GColor8 x, GColor8 y)
+{
+    return x.argb == y.argb;
+}
+
+#define GColorClear ((GColor8){.argb = 0x00})
+#define GColorBlack ((GColor8){.argb = 0xC0})
+#define GColorWhite ((GColor8){.argb = 0xFF})
+#define GColorOxfordBlue ((GColor8){.argb = 0xC1})
+#define GColorBabyBlueEyes ((GColor8){.argb = 0xEB})
+#define GColorVeryLightBlue ((GColor8){.argb = 0xD7})
+#define GColorIslamicGreen ((GColor8){.argb = 0xC8})
+#define GColorVividCerulean ((GColor8){.argb = 0xCB})
+#define GColorRajah ((GColor8){.argb = 0xF9})
+#define GColorRed ((GColor8){.argb = 0xF0})
+#define GColorSunsetOrange ((GColor8){.argb = 0xF5})
+#define GColorLiberty ((GColor8){.argb = 0xD6})
+#define GColorMelon ((GColor8){.argb = 0xFA})
+#define GColorPictonBlue ((GColor8){.argb = 0xDB})
+#define GColorYellow ((GColor8){.argb = 0xFC})
+
+typedef enum
+{
+    GCornerNone = 0,
+    GCornersAll = 0xF,
+} GCornerMask;
+
+typedef enum
+{
+    GCompOpAssign,
+    GCompOpAssignInverted,
+    GCompOpOr,
+    GCompOpAnd,
+    GCompOpClear,
+    GCompOpSet,
+} GCompOp;
+
+typedef enum
+{
+    GAlignCenter,
+} GAlign;
+
+typedef enum
+{
+    GTextAlignmentLeft,
+    GTextAlignmentCenter,
+    GTextAlignmentRight,
+} GTextAlignment;
+
+typedef enum
+{
+    GTextOverflowModeWordWrap,
+    GTextOverflowModeTrailingEllipsis,
+    GTextOverflowModeFill,
+} GTextOverflowMode;
+
+typedef struct GTextAttributes GTextAttributes;
+
+// Bitmaps
+typedef enum
+{
+    GBitmapFormat1Bit,
+    GBitmapFormat8Bit,
+} GBitmapFormat;
+
+typedef struct GBitmap GBitmap;
+
+typedef struct
+{
+    uint8_t *data;
+    int16_t min_x;
+    int16_t max_x;
+} GBitmapDataRowInfo;
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id);
+void gbitmap_destroy(GBitmap *bitmap);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y);
+
+#define RESOURCE_ID_IMAGE_FUJI_80 1
+
+// Paths
+typedef struct
+{
+    uint32_t num_points;
+    GPoint *points;
+    int32_t rotation;
+    GPoint offset;
+} GPath;
+
+void gpath_move_to(GPath *path, GPoint point);
+
+// Fonts
+typedef const char *GFont;
+
+#define FONT_KEY_GOTHIC_14_BOLD "GOTHIC_14_BOLD"
+#define FONT_KEY_GOTHIC_18_BOLD "GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24_BOLD "GOTHIC_24_BOLD"
+
+GFont fonts_get_system_font(const char *font_key);
+
+// Drawing, every call is recorded by the graphics context it is made on
+typedef struct GContext GContext;
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void gpath_draw_filled(GContext *ctx, GPath *path);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode,
+                        GTextAlignment alignment, GTextAttributes *text_attributes);
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode, GTextAlignment alignment);
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+// Layers and windows
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef struct BitmapLayer BitmapLayer;
+typedef struct Window Window;
+
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+void layer_destroy(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_mark_dirty(Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+void layer_set_frame(Layer *layer, GRect frame);
+GPoint layer_convert_point_to_screen(const Layer *layer, GPoint point);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment);
+
+BitmapLayer *bitmap_layer_create(GRect frame);
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer);
+Layer *bitmap_layer_get_layer(BitmapLayer *bitmap_layer);
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap);
+void bitmap_layer_set_alignment(BitmapLayer *bitmap_layer, GAlign alignment);
+void bitmap_layer_set_background_color(BitmapLayer *bitmap_layer, GColor color);
+void bitmap_layer_set_compositing_mode(BitmapLayer *bitmap_layer, GCompOp mode);
+
+typedef void (*WindowHandler)(Window *window);
+typedef struct
+{
+    WindowHandler load;
+    WindowHandler appear;
+    WindowHandler disappear;
+    WindowHandler unload;
+} WindowHandlers;
+
+typedef enum
+{
+    BUTTON_ID_BACK,
+    BUTTON_ID_UP,
+    BUTTON_ID_SELECT,
+    BUTTON_ID_DOWN,
+} ButtonId;
+
+typedef void *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider);
+void window_set_background_color(Window *window, GColor color);
+Layer *window_get_root_layer(const Window *window);
+void window_stack_push(Window *window, bool animated);
+bool window_stack_remove(Window *window, bool animated);
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler,
+                                 ClickHandler up_handler);
+
+// Storage, kept in memory for the life of the process
+#define PERSIST_DATA_MAX_LENGTH 256
+#define E_DOES_NOT_EXIST -10
+
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size);
+int persist_write_data(uint32_t key, const void *data, size_t size);
+
+// Time, which a host run can set so code that depends on the day can be tested at any date
+time_t host_time(time_t *tloc);
+#define time(tloc) host_time(tloc)
+
+// Host only: draws the layer tree of the top window into a recording context, see pebble_stub.c
+typedef struct
+{
+    uint16_t lines;
+    uint16_t path_fills;
+    uint16_t rect_fills;
+    uint16_t bitmaps;
+    uint16_t texts;
+    uint16_t allocations;
+    uint32_t pixels;
+    uint32_t allocated_bytes;
+} HostRecording;
+
+GContext *host_graphics_context(void);
+void host_recording_reset(void);
+const HostRecording *host_recording(void);
+void host_render_top_window(void);
+uint32_t host_error_count(void);
+// Fixes the time the app sees, 0 goes back to the real time
+void host_set_time(time_t now);
+// Forgets everything persisted, as if the app had been reinstalled
+void host_persist_clear(void);
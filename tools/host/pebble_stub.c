@@ -0,0 +1,567 @@
+#include <pebble.h>
+#include <stdarg.h>
+
+// Children a layer can hold, the main window nests at most nine
+#define LAYER_CHILDREN_MAX 16
+#define WINDOW_STACK_MAX 4
+
+struct GBitmap
+{
+    GSize size;
+    GBitmapFormat format;
+    uint16_t bytes_per_row;
+    uint8_t *data;
+};
+
+struct Layer
+{
+    Layer *parent;
+    GRect frame;
+    LayerUpdateProc update_proc;
+    Layer *children[LAYER_CHILDREN_MAX];
+    uint8_t child_count;
+};
+
+struct TextLayer
+{
+    Layer layer;
+};
+
+struct BitmapLayer
+{
+    Layer layer;
+};
+
+struct Window
+{
+    Layer root;
+    WindowHandlers handlers;
+    bool loaded;
+};
+
+// A context that draws nothing but records every call, with the same cost measures as render_stats.c
+struct GContext
+{
+    GBitmap *frame_buffer;
+    uint8_t stroke_width;
+};
+
+static GContext s_context;
+static HostRecording s_recording;
+static Window *s_window_stack[WINDOW_STACK_MAX];
+static uint8_t s_window_count;
+static uint32_t s_error_count;
+
+void host_app_log(AppLogLevel level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n");
+
+    if (level == APP_LOG_LEVEL_ERROR)
+        s_error_count++;
+}
+
+uint32_t host_error_count(void)
+{
+    return s_error_count;
+}
+
+bool grect_equal(const GRect *rect_a, const GRect *rect_b)
+{
+    return rect_a->origin.x == rect_b->origin.x && rect_a->origin.y == rect_b->origin.y &&
+           rect_a->size.w == rect_b->size.w && rect_a->size.h == rect_b->size.h;
+}
+
+static int16_t abs16(int16_t value)
+{
+    return value < 0 ? -value : value;
+}
+
+static uint32_t rect_area(GRect rect)
+{
+    return (uint32_t)abs16(rect.size.w) * (uint32_t)abs16(rect.size.h);
+}
+
+// Bitmaps
+
+static GBitmap *create_bitmap(GSize size, GBitmapFormat format)
+{
+    GBitmap *bitmap = calloc(1, sizeof(GBitmap));
+    bitmap->size = size;
+    bitmap->format = format;
+    // 1-bit rows are padded to whole words like on the watch
+    bitmap->bytes_per_row = format == GBitmapFormat8Bit ? size.w : ((size.w + 31) / 32) * 4;
+    bitmap->data = calloc((size_t)bitmap->bytes_per_row * size.h, 1);
+    return bitmap;
+}
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format)
+{
+    GBitmap *bitmap = create_bitmap(size, format);
+    s_recording.allocations++;
+    s_recording.allocated_bytes += (uint32_t)bitmap->bytes_per_row * size.h;
+    return bitmap;
+}
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id)
+{
+    return create_bitmap(GSize(80, 80), PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit));
+}
+
+void gbitmap_destroy(GBitmap *bitmap)
+{
+    if (!bitmap)
+        return;
+    free(bitmap->data);
+    free(bitmap);
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap)
+{
+    return bitmap->data;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap)
+{
+    return bitmap->bytes_per_row;
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap)
+{
+    return GRect(0, 0, bitmap->size.w, bitmap->size.h);
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y)
+{
+    GBitmapDataRowInfo row = {
+        .data = bitmap->data + (size_t)y * bitmap->bytes_per_row,
+        .min_x = 0,
+        .max_x = bitmap->size.w - 1,
+    };
+#ifdef PBL_ROUND
+    // Only the part of each row inside the circle exists on a round display
+    const double radius = bitmap->size.w / 2.0;
+    const double dy = y + 0.5 - radius;
+    const int16_t half_width = dy * dy < radius * radius ? (int16_t)sqrt(radius * radius - dy * dy) : 0;
+    row.min_x = (int16_t)radius - half_width;
+    row.max_x = (int16_t)radius + half_width - 1;
+#endif
+    return row;
+}
+
+void gpath_move_to(GPath *path, GPoint point)
+{
+    path->offset = point;
+}
+
+GFont fonts_get_system_font(const char *font_key)
+{
+    return font_key;
+}
+
+// Recording context
+
+GContext *host_graphics_context(void)
+{
+    if (!s_context.frame_buffer)
+    {
+        s_context.frame_buffer = create_bitmap(GSize(PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT),
+                                               PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit));
+        s_context.stroke_width = 1;
+    }
+    return &s_context;
+}
+
+void host_recording_reset(void)
+{
+    s_recording = (HostRecording){0};
+}
+
+const HostRecording *host_recording(void)
+{
+    return &s_recording;
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color)
+{
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color)
+{
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color)
+{
+}
+
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width)
+{
+    ctx->stroke_width = stroke_width;
+}
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode)
+{
+}
+
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1)
+{
+    const int16_t dx = abs16(p1.x - p0.x);
+    const int16_t dy = abs16(p1.y - p0.y);
+    s_recording.lines++;
+    s_recording.pixels += (uint32_t)((dx > dy ? dx : dy) + 1) * ctx->stroke_width;
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask)
+{
+    s_recording.rect_fills++;
+    s_recording.pixels += rect_area(rect);
+}
+
+void gpath_draw_filled(GContext *ctx, GPath *path)
+{
+    if (path->num_points == 0)
+        return;
+
+    int16_t min_x = path->points[0].x, max_x = min_x;
+    int16_t min_y = path->points[0].y, max_y = min_y;
+    for (uint32_t i = 1; i < path->num_points; i++)
+    {
+        min_x = path->points[i].x < min_x ? path->points[i].x : min_x;
+        max_x = path->points[i].x > max_x ? path->points[i].x : max_x;
+        min_y = path->points[i].y < min_y ? path->points[i].y : min_y;
+        max_y = path->points[i].y > max_y ? path->points[i].y : max_y;
+    }
+    s_recording.path_fills++;
+    s_recording.pixels += (uint32_t)(max_x - min_x + 1) * (uint32_t)(max_y - min_y + 1);
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect)
+{
+    s_recording.bitmaps++;
+    s_recording.pixels += rect_area(rect);
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode,
+                        GTextAlignment alignment, GTextAttributes *text_attributes)
+{
+    s_recording.texts++;
+    s_recording.pixels += rect_area(box);
+}
+
+// Every line of text is taken to fill the box, the most a measured box can be
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode, GTextAlignment alignment)
+{
+    return box.size;
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx)
+{
+    return ctx->frame_buffer;
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer)
+{
+    return true;
+}
+
+// Layers
+
+static void init_layer(Layer *layer, GRect frame)
+{
+    *layer = (Layer){.frame = frame};
+}
+
+Layer *layer_create(GRect frame)
+{
+    Layer *layer = malloc(sizeof(Layer));
+    init_layer(layer, frame);
+    return layer;
+}
+
+void layer_destroy(Layer *layer)
+{
+    free(layer);
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc)
+{
+    layer->update_proc = update_proc;
+}
+
+void layer_add_child(Layer *parent, Layer *child)
+{
+    if (parent->child_count < LAYER_CHILDREN_MAX)
+    {
+        parent->children[parent->child_count++] = child;
+        child->parent = parent;
+    }
+}
+
+void layer_mark_dirty(Layer *layer)
+{
+}
+
+GRect layer_get_bounds(const Layer *layer)
+{
+    return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+void layer_set_frame(Layer *layer, GRect frame)
+{
+    layer->frame = frame;
+}
+
+// Bounds always start at the frame origin here, so only the frames of the layer and its ancestors move a point
+GPoint layer_convert_point_to_screen(const Layer *layer, GPoint point)
+{
+    for (; layer; layer = layer->parent)
+    {
+        point.x += layer->frame.origin.x;
+        point.y += layer->frame.origin.y;
+    }
+    return point;
+}
+
+// Text and bitmap layers are drawn by the firmware rather than the app, so they record nothing
+
+TextLayer *text_layer_create(GRect frame)
+{
+    TextLayer *text_layer = malloc(sizeof(TextLayer));
+    init_layer(&text_layer->layer, frame);
+    return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer)
+{
+    free(text_layer);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer)
+{
+    return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text)
+{
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color)
+{
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color)
+{
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font)
+{
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment)
+{
+}
+
+BitmapLayer *bitmap_layer_create(GRect frame)
+{
+    BitmapLayer *bitmap_layer = malloc(sizeof(BitmapLayer));
+    init_layer(&bitmap_layer->layer, frame);
+    return bitmap_layer;
+}
+
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer)
+{
+    free(bitmap_layer);
+}
+
+Layer *bitmap_layer_get_layer(BitmapLayer *bitmap_layer)
+{
+    return &bitmap_layer->layer;
+}
+
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap)
+{
+}
+
+void bitmap_layer_set_alignment(BitmapLayer *bitmap_layer, GAlign alignment)
+{
+}
+
+void bitmap_layer_set_background_color(BitmapLayer *bitmap_layer, GColor color)
+{
+}
+
+void bitmap_layer_set_compositing_mode(BitmapLayer *bitmap_layer, GCompOp mode)
+{
+}
+
+// Windows
+
+Window *window_create(void)
+{
+    Window *window = malloc(sizeof(Window));
+    *window = (Window){0};
+    init_layer(&window->root, GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+    return window;
+}
+
+void window_destroy(Window *window)
+{
+    if (!window)
+        return;
+    window_stack_remove(window, false);
+    free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers)
+{
+    window->handlers = handlers;
+}
+
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider)
+{
+}
+
+void window_set_background_color(Window *window, GColor color)
+{
+}
+
+Layer *window_get_root_layer(const Window *window)
+{
+    return (Layer *)&window->root;
+}
+
+void window_stack_push(Window *window, bool animated)
+{
+    if (s_window_count == WINDOW_STACK_MAX)
+        return;
+
+    s_window_stack[s_window_count++] = window;
+    if (!window->loaded && window->handlers.load)
+        window->handlers.load(window);
+    window->loaded = true;
+}
+
+bool window_stack_remove(Window *window, bool animated)
+{
+    for (uint8_t i = 0; i < s_window_count; i++)
+    {
+        if (s_window_stack[i] != window)
+            continue;
+
+        s_window_count--;
+        memmove(s_window_stack + i, s_window_stack + i + 1, (s_window_count - i) * sizeof(Window *));
+        if (window->loaded && window->handlers.unload)
+            window->handlers.unload(window);
+        window->loaded = false;
+        window->root.child_count = 0;
+        return true;
+    }
+    return false;
+}
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler)
+{
+}
+
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler,
+                                 ClickHandler up_handler)
+{
+}
+
+// Persisted values, the firmware keeps at most PERSIST_DATA_MAX_LENGTH bytes per key
+#define PERSIST_KEYS_MAX 16
+
+typedef struct
+{
+    uint32_t key;
+    size_t size;
+    uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} HostPersistValue;
+
+static HostPersistValue s_persist[PERSIST_KEYS_MAX];
+static uint8_t s_persist_count;
+static time_t s_host_time;
+
+static HostPersistValue *find_persist_value(uint32_t key)
+{
+    for (uint8_t i = 0; i < s_persist_count; i++)
+    {
+        if (s_persist[i].key == key)
+            return &s_persist[i];
+    }
+    return NULL;
+}
+
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size)
+{
+    const HostPersistValue *value = find_persist_value(key);
+    if (!value)
+        return E_DOES_NOT_EXIST;
+
+    const size_t size = value->size < buffer_size ? value->size : buffer_size;
+    memcpy(buffer, value->data, size);
+    return (int)size;
+}
+
+int persist_write_data(uint32_t key, const void *data, size_t size)
+{
+    if (size > PERSIST_DATA_MAX_LENGTH)
+        size = PERSIST_DATA_MAX_LENGTH;
+
+    HostPersistValue *value = find_persist_value(key);
+    if (!value)
+    {
+        if (s_persist_count == PERSIST_KEYS_MAX)
+        {
+            s_error_count++;
+            return -1;
+        }
+        value = &s_persist[s_persist_count++];
+        value->key = key;
+    }
+    memcpy(value->data, data, size);
+    value->size = size;
+    return (int)size;
+}
+
+void host_persist_clear(void)
+{
+    s_persist_count = 0;
+}
+
+// The parentheses call the C library's time rather than the macro in pebble.h
+time_t host_time(time_t *tloc)
+{
+    const time_t now = s_host_time ? s_host_time : (time)(NULL);
+    if (tloc)
+        *tloc = now;
+    return now;
+}
+
+void host_set_time(time_t now)
+{
+    s_host_time = now;
+}
+
+// Draws a layer and then its children, the order the firmware uses
+static void render_layer(Layer *layer, GContext *ctx)
+{
+    if (layer->update_proc)
+        layer->update_proc(layer, ctx);
+    for (uint8_t i = 0; i < layer->child_count; i++)
+    {
+        render_layer(layer->children[i], ctx);
+    }
+}
+
+void host_render_top_window(void)
+{
+    if (s_window_count == 0)
+        return;
+
+    render_layer(&s_window_stack[s_window_count - 1]->root, host_graphics_context());
+}
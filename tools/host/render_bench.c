@@ -0,0 +1,257 @@
+// Host rendering benchmark, see the Makefile. Builds the real ui.c and graphics.c against the stub SDK in include/,
+// draws the main window for every morning/afternoon score bucket pair and fails when a frame costs more than
+// src/c/utility/render_stats_baseline.h allows, when the recorded drawing disagrees with the in-app counters or
+// when anything logs an error. It also checks score image captures are only reused where they were taken from.
+// `render_bench --baseline` prints the baselines update_render_baselines.py checks in.
+#include <pebble.h>
+#include "../../src/c/app/ui.h"
+#include "../../src/c/utility/graphics.h"
+#include "../../src/c/utility/render_stats.h"
+#include "../../src/c/utility/utility.h"
+
+// One score per bucket, the same ones the select sweep in ui.c steps through
+static const int8_t s_bucket_scores[SCORE_BUCKET_COUNT] = {0, 3, 6, 8};
+// First frame draws and captures each image, the second blits the captures
+#define FRAME_PASSES 2
+
+static int8_t s_scores[TIME_PERIOD_COUNT];
+
+// The parts of data.c the UI reads, backed by the scores the benchmark sets
+
+Region get_current_region(void)
+{
+    return (Region)0;
+}
+
+void set_current_region(Region region)
+{
+}
+
+const char *get_region_name(Region region)
+{
+    static const char *const names[REGION_COUNT] = {
+#define REGION_NAME(id, name) name,
+        REGION_TABLE(REGION_NAME)
+#undef REGION_NAME
+    };
+    return names[region];
+}
+
+int8_t get_current_region_score(TimePeriod time)
+{
+    return s_scores[time];
+}
+
+bool set_region_score(Region region, TimePeriod time, int8_t score)
+{
+    const bool changed = s_scores[time] != score;
+    s_scores[time] = score;
+    return changed;
+}
+
+bool is_data_loaded(void)
+{
+    return true;
+}
+
+bool is_data_stale(void)
+{
+    return false;
+}
+
+static void max_stats(RenderStats *max, const RenderStats *stats)
+{
+#define MAX_FIELD(field) max->field = stats->field > max->field ? stats->field : max->field
+    MAX_FIELD(lines);
+    MAX_FIELD(path_fills);
+    MAX_FIELD(rect_fills);
+    MAX_FIELD(bitmaps);
+    MAX_FIELD(texts);
+    MAX_FIELD(allocations);
+    MAX_FIELD(pixels);
+#undef MAX_FIELD
+}
+
+// What a frame costs beyond its two images, never below zero
+static RenderStats subtract_images(const RenderStats *frame, const RenderStats *morning, const RenderStats *afternoon)
+{
+    RenderStats rest;
+#define REST_FIELD(field)                                                                                              \
+    rest.field = frame->field > morning->field + afternoon->field ? frame->field - morning->field - afternoon->field : 0
+    REST_FIELD(lines);
+    REST_FIELD(path_fills);
+    REST_FIELD(rect_fills);
+    REST_FIELD(bitmaps);
+    REST_FIELD(texts);
+    REST_FIELD(allocations);
+    REST_FIELD(pixels);
+#undef REST_FIELD
+    return rest;
+}
+
+// The stub context sees every call that reaches the SDK, so any gap means a draw call bypasses the counters
+static bool matches_recording(const RenderStats *stats, const HostRecording *recording)
+{
+    return stats->lines == recording->lines && stats->path_fills == recording->path_fills &&
+           stats->rect_fills == recording->rect_fills && stats->bitmaps == recording->bitmaps &&
+           stats->texts == recording->texts && stats->allocations == recording->allocations &&
+           stats->pixels == recording->pixels;
+}
+
+static void print_stats(const RenderStats *stats)
+{
+    const struct
+    {
+        const char *name;
+        uint32_t value;
+    } fields[] = {
+        {"lines", stats->lines},           {"path_fills", stats->path_fills}, {"rect_fills", stats->rect_fills},
+        {"bitmaps", stats->bitmaps},       {"texts", stats->texts},           {"allocations", stats->allocations},
+        {"pixels", stats->pixels},
+    };
+
+    const char *separator = "";
+    printf("{");
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+    {
+        if (fields[i].value == 0)
+            continue;
+        printf("%s.%s = %lu", separator, fields[i].name, (unsigned long)fields[i].value);
+        separator = ", ";
+    }
+    printf("%s}\n", *separator ? "" : "0");
+}
+
+// Each image drawn on its own at both positions, first and cached, from a full screen layer like the main window's
+static void measure_images(RenderStats images[SCORE_BUCKET_COUNT])
+{
+    GContext *ctx = host_graphics_context();
+    Layer *layer = layer_create(GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+    for (ScoreBucket bucket = 0; bucket < SCORE_BUCKET_COUNT; bucket++)
+    {
+        images[bucket] = (RenderStats){0};
+        for (TimePeriod time = TIME_MORNING; time <= TIME_AFTERNOON; time++)
+        {
+            score_image_cache_deinit();
+            for (int pass = 0; pass < FRAME_PASSES; pass++)
+            {
+                render_stats_frame_begin();
+                graphics_context_set_stroke_width(ctx, DRAWING_STROKE);
+                draw_score_image(s_bucket_scores[bucket], ctx, layer, get_layout()->score_image[time],
+                                 SCORE_IMAGE_SIZE, TIME_MORNING_BUBBLE_COLOR);
+                max_stats(&images[bucket], render_stats_get_frame());
+            }
+        }
+    }
+    score_image_cache_deinit();
+    layer_destroy(layer);
+}
+
+// Whether drawing an image blits a capture rather than drawing it afresh
+static bool draws_from_cache(GContext *ctx, Layer *layer, GColor background)
+{
+    host_recording_reset();
+    draw_score_image(s_bucket_scores[SCORE_BUCKET_VISIBLE], ctx, layer, get_layout()->score_image[TIME_MORNING],
+                     SCORE_IMAGE_SIZE, background);
+    return host_recording()->bitmaps > 0;
+}
+
+// A capture holds the pixels behind the image, so it may only be blitted at the same spot on screen over the same
+// colour. Returns the number of draws that got that wrong.
+static uint32_t check_image_cache(void)
+{
+    GContext *ctx = host_graphics_context();
+    Layer *parent = layer_create(GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+    Layer *layer = layer_create(GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+    layer_add_child(parent, layer);
+
+    score_image_cache_deinit();
+    uint32_t failures = 0;
+    failures += draws_from_cache(ctx, layer, TIME_MORNING_BUBBLE_COLOR);
+    failures += !draws_from_cache(ctx, layer, TIME_MORNING_BUBBLE_COLOR);
+    failures += draws_from_cache(ctx, layer, GColorClear);
+    // The same layer coordinates a few pixels further down the screen
+    layer_set_frame(parent, GRect(0, 4, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+    failures += draws_from_cache(ctx, layer, TIME_MORNING_BUBBLE_COLOR);
+    score_image_cache_deinit();
+
+    layer_destroy(layer);
+    layer_destroy(parent);
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    const bool baseline = argc > 1 && strcmp(argv[1], "--baseline") == 0;
+
+    RenderStats images[SCORE_BUCKET_COUNT];
+    RenderStats frame_baseline = {0};
+    if (baseline)
+        measure_images(images);
+
+    s_scores[TIME_MORNING] = s_bucket_scores[SCORE_BUCKET_VISIBLE];
+    s_scores[TIME_AFTERNOON] = s_bucket_scores[SCORE_BUCKET_VISIBLE];
+    ui_init();
+
+    uint32_t mismatches = 0;
+    for (ScoreBucket morning = 0; morning < SCORE_BUCKET_COUNT; morning++)
+    {
+        for (ScoreBucket afternoon = 0; afternoon < SCORE_BUCKET_COUNT; afternoon++)
+        {
+            set_region_score(get_current_region(), TIME_MORNING, s_bucket_scores[morning]);
+            set_region_score(get_current_region(), TIME_AFTERNOON, s_bucket_scores[afternoon]);
+            update_all();
+
+            score_image_cache_deinit();
+            for (int pass = 0; pass < FRAME_PASSES; pass++)
+            {
+                host_recording_reset();
+                host_render_top_window();
+
+                const RenderStats *frame = render_stats_get_frame();
+                const HostRecording *recording = host_recording();
+                if (!matches_recording(frame, recording))
+                {
+                    printf("[RenderBench] FAIL buckets=%d/%d pass %d: counted %u lines %u rects %lu pixels, "
+                           "recorded %u lines %u rects %lu pixels\n",
+                           morning, afternoon, pass, frame->lines, frame->rect_fills, (unsigned long)frame->pixels,
+                           recording->lines, recording->rect_fills, (unsigned long)recording->pixels);
+                    mismatches++;
+                }
+
+                if (baseline)
+                {
+                    RenderStats rest = subtract_images(frame, &images[morning], &images[afternoon]);
+                    max_stats(&frame_baseline, &rest);
+                }
+            }
+        }
+    }
+    ui_deinit();
+    score_image_cache_deinit();
+
+    const uint32_t cache_failures = check_image_cache();
+    if (cache_failures > 0)
+        printf("[RenderBench] FAIL: %lu score image draws reused the wrong capture or none\n",
+               (unsigned long)cache_failures);
+
+    if (baseline)
+    {
+        printf("frame ");
+        print_stats(&frame_baseline);
+        for (ScoreBucket bucket = 0; bucket < SCORE_BUCKET_COUNT; bucket++)
+        {
+            printf("image %d ", bucket);
+            print_stats(&images[bucket]);
+        }
+        return mismatches == 0 && cache_failures == 0 ? 0 : 1;
+    }
+
+    // render_stats_frame_end logs an error for every stat of a frame over its baseline
+    const uint32_t errors = host_error_count();
+    const bool passed = errors == 0 && mismatches == 0 && cache_failures == 0;
+    printf("[RenderBench] %s: %u frames, %lu errors logged, %lu frames not matching the recording\n",
+           passed ? "PASS" : "FAIL", SCORE_BUCKET_COUNT * SCORE_BUCKET_COUNT * FRAME_PASSES, (unsigned long)errors,
+           (unsigned long)mismatches);
+    return passed ? 0 : 1;
+}
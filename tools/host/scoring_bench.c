@@ -0,0 +1,106 @@
+// Scores the samples tools/host/scoring_parity.js writes with the C port of the scoring engine, see the Makefile.
+// Input: little endian uint32 hour count and batch size, then per batch an int16 dampening, then the columns of
+// every hour: cloud cover, humidity and weather code bytes and uint16 precipitation. Output: one score byte per hour.
+#define _POSIX_C_SOURCE 200809L
+#include "../../src/c/utility/visibility_score.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return NULL;
+
+    fseek(file, 0, SEEK_END);
+    *size = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t *data = malloc(*size);
+    if (data && fread(data, 1, *size, file) != *size)
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+static uint32_t read_u32(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s <samples file> <scores file>\n", argv[0]);
+        return 2;
+    }
+
+    size_t size;
+    uint8_t *input = read_file(argv[1], &size);
+    if (!input || size < 8)
+    {
+        fprintf(stderr, "[ScoringBench] Cannot read %s\n", argv[1]);
+        return 2;
+    }
+
+    const uint32_t count = read_u32(input);
+    const uint32_t batch = read_u32(input + 4);
+    const uint32_t batches = (count + batch - 1) / batch;
+    if (batch == 0 || batch > UINT16_MAX || size != 8 + batches * 2 + (size_t)count * 5)
+    {
+        fprintf(stderr, "[ScoringBench] Malformed samples file\n");
+        return 2;
+    }
+
+    const int16_t *dampenings = (const int16_t *)(input + 8);
+    const uint8_t *columns = input + 8 + batches * 2;
+    // The precipitation column need not be aligned in the file
+    uint16_t *precipitation = malloc((size_t)count * sizeof(uint16_t));
+    memcpy(precipitation, columns + count * 3, (size_t)count * sizeof(uint16_t));
+    const VisibilityColumns all = {
+        .cloud_cover_low = columns,
+        .relative_humidity = columns + count,
+        .weather_code = columns + count * 2,
+        .precipitation = precipitation,
+    };
+    uint8_t *scores = malloc(count);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t first = 0, i = 0; first < count; first += batch, i++)
+    {
+        const VisibilityColumns columns_batch = {
+            .cloud_cover_low = all.cloud_cover_low + first,
+            .relative_humidity = all.relative_humidity + first,
+            .weather_code = all.weather_code + first,
+            .precipitation = all.precipitation + first,
+        };
+        const uint16_t length = count - first < batch ? count - first : batch;
+        score_visibility(&columns_batch, dampenings[i], scores + first, length);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    FILE *output = fopen(argv[2], "wb");
+    if (!output || fwrite(scores, 1, count, output) != count)
+    {
+        fprintf(stderr, "[ScoringBench] Cannot write %s\n", argv[2]);
+        return 2;
+    }
+    fclose(output);
+
+    printf("%.1f\n", elapsed_ms(start, end));
+    free(scores);
+    free(precipitation);
+    free(input);
+    return 0;
+}
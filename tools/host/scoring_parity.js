@@ -0,0 +1,118 @@
+/**
+ * Checks that the C port of the scoring engine, src/c/utility/visibility_score.c, scores every hour exactly like
+ * src/pkjs/scoring.js, and times both. Run through `make check`, or as
+ * `node scoring_parity.js build/scoring_bench [hours]`. Exits non-zero on any hour the two score differently.
+ */
+const { execFileSync } = require('child_process')
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+
+const { scoreVisibility, toFixedDampening } = require('../../src/pkjs/scoring.js')
+const regions = require('../../src/pkjs/regions.json')
+
+const benchPath = process.argv[2]
+const count = parseInt(process.argv[3], 10) || 4000000
+/**
+ * Hours scored per call with one dampening, about a forecast's worth for a few points
+ */
+const batchSize = 256
+
+/**
+ * Seeded xorshift32, so every run checks the same samples
+ */
+let state = 0x2545F491
+function random(limit) {
+    state ^= state << 13
+    state ^= state >>> 17
+    state ^= state << 5
+    return (state >>> 0) % limit
+}
+
+/**
+ * Samples cover every branch of the engine: reports beyond the valid ranges, every weather code and rain on both
+ * sides of the heavy rain threshold, with the regions' own dampenings and arbitrary ones
+ */
+function createSamples() {
+    const batches = Math.ceil(count / batchSize)
+    const regionDampenings = regions.map(({ dampening }) => toFixedDampening(dampening))
+    const dampenings = new Int16Array(batches)
+    for (let i = 0; i < batches; i++) {
+        dampenings[i] = i % 2 === 0 ? regionDampenings[random(regionDampenings.length)] : random(1001)
+    }
+
+    const cloudCoverLow = new Uint8Array(count)
+    const relativeHumidity = new Uint8Array(count)
+    const weatherCode = new Uint8Array(count)
+    const precipitation = new Uint16Array(count)
+    for (let i = 0; i < count; i++) {
+        cloudCoverLow[i] = random(64) === 0 ? random(256) : random(101)
+        relativeHumidity[i] = random(101)
+        weatherCode[i] = random(8) === 0 ? random(256) : random(100)
+        precipitation[i] = random(4) === 0 ? random(1001) : 0
+    }
+    return { dampenings, cloudCoverLow, relativeHumidity, weatherCode, precipitation }
+}
+
+function scoreWithJs({ dampenings, cloudCoverLow, relativeHumidity, weatherCode, precipitation }) {
+    // The phone sees millimetres as Open-Meteo sends them
+    const millimetres = Float64Array.from(precipitation, hundredths => hundredths / 100)
+    const scores = new Uint8Array(count)
+
+    const start = process.hrtime.bigint()
+    for (let first = 0, batch = 0; first < count; first += batchSize, batch++) {
+        const last = Math.min(first + batchSize, count)
+        scoreVisibility({
+            cloudCoverLow: cloudCoverLow.subarray(first, last),
+            relativeHumidity: relativeHumidity.subarray(first, last),
+            weatherCode: weatherCode.subarray(first, last),
+            precipitation: millimetres.subarray(first, last),
+        }, dampenings[batch], scores.subarray(first, last))
+    }
+    const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6
+    return { scores, elapsedMs }
+}
+
+function scoreWithC({ dampenings, cloudCoverLow, relativeHumidity, weatherCode, precipitation }) {
+    const header = Buffer.alloc(8)
+    header.writeUInt32LE(count, 0)
+    header.writeUInt32LE(batchSize, 4)
+    const directory = fs.mkdtempSync(path.join(os.tmpdir(), 'scoring-'))
+    const samplesPath = path.join(directory, 'samples.bin')
+    const scoresPath = path.join(directory, 'scores.bin')
+    fs.writeFileSync(samplesPath, Buffer.concat([header, Buffer.from(dampenings.buffer),
+        Buffer.from(cloudCoverLow.buffer), Buffer.from(relativeHumidity.buffer), Buffer.from(weatherCode.buffer),
+        Buffer.from(precipitation.buffer)]))
+
+    try {
+        const elapsedMs = parseFloat(execFileSync(benchPath, [samplesPath, scoresPath], { encoding: 'utf8' }))
+        return { scores: new Uint8Array(fs.readFileSync(scoresPath)), elapsedMs }
+    } finally {
+        fs.rmSync(directory, { recursive: true, force: true })
+    }
+}
+
+function main() {
+    if (os.endianness() !== 'LE') throw new Error('The samples file is written little endian')
+
+    const samples = createSamples()
+    const js = scoreWithJs(samples)
+    const c = scoreWithC(samples)
+
+    let mismatches = 0
+    for (let i = 0; i < count; i++) {
+        if (js.scores[i] === c.scores[i]) continue
+        if (mismatches++ < 10) {
+            console.log(`[ScoringParity] hour ${i}: JS ${js.scores[i]}, C ${c.scores[i]} for cloud cover ` +
+                `${samples.cloudCoverLow[i]}, humidity ${samples.relativeHumidity[i]}, code ` +
+                `${samples.weatherCode[i]}, precipitation ${samples.precipitation[i] / 100} mm, dampening ` +
+                `${samples.dampenings[Math.floor(i / batchSize)]}`)
+        }
+    }
+
+    console.log(`[ScoringParity] ${mismatches === 0 ? 'PASS' : 'FAIL'}: ${count} hours, ${mismatches} differ, ` +
+        `JS ${js.elapsedMs.toFixed(1)} ms, C ${c.elapsedMs.toFixed(1)} ms`)
+    process.exit(mismatches === 0 ? 0 : 1)
+}
+
+main()
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""
+Rewrites src/c/utility/render_stats_baseline.h from the host render benchmark.
+
+Run through `make baselines`, which builds tools/host/build/render_bench_<platform>_<variant> first. Each binary
+run with --baseline prints the largest cost of the frame outside the score images and of each score image, over
+every bucket pair, first and cached frames. Platforms that measure the same share one block of the header.
+"""
+import subprocess
+import sys
+
+PLATFORMS = ['aplite', 'basalt', 'chalk', 'diorite', 'emery']
+BUCKETS = ['SCORE_BUCKET_NOT_VISIBLE', 'SCORE_BUCKET_BARELY_VISIBLE', 'SCORE_BUCKET_PARTLY_VISIBLE',
+           'SCORE_BUCKET_VISIBLE']
+
+HEADER = '''#pragma once
+
+#include "render_stats.h"
+
+// Upper bounds for one main window frame, generated by tools/host/update_render_baselines.py from the host render
+// benchmark running each platform through every score bucket, do not edit.
+// A frame may cost at most the fixed baseline plus the image baselines of the morning and afternoon buckets.
+// Image baselines cover both the first frame (drawn and captured) and later frames (one cached blit).
+'''
+
+
+def measure(build_dir, platform, variant):
+    result = subprocess.run(['{}/render_bench_{}_{}'.format(build_dir, platform, variant), '--baseline'],
+                            stdout=subprocess.PIPE, universal_newlines=True)
+    if result.returncode != 0:
+        sys.exit('render_bench_{}_{} failed, fix the drawing before taking baselines'.format(platform, variant))
+
+    frame = None
+    images = [None] * len(BUCKETS)
+    for line in result.stdout.splitlines():
+        if line.startswith('frame '):
+            frame = line[len('frame '):]
+        elif line.startswith('image '):
+            _, bucket, stats = line.split(' ', 2)
+            images[int(bucket)] = stats
+    return frame, tuple(images)
+
+
+def main():
+    build_dir, header_path = sys.argv[1], sys.argv[2]
+
+    # (layers frame, single layer frame, images) -> platforms measuring exactly that
+    groups = {}
+    for platform in PLATFORMS:
+        layers_frame, layers_images = measure(build_dir, platform, 'layers')
+        single_frame, single_images = measure(build_dir, platform, 'single')
+        if layers_images != single_images:
+            sys.exit('{} draws different score images per variant'.format(platform))
+        groups.setdefault((layers_frame, single_frame, layers_images), []).append(platform)
+
+    lines = [HEADER]
+    for i, ((layers_frame, single_frame, images), platforms) in enumerate(groups.items()):
+        condition = ' || '.join('defined(PBL_PLATFORM_{})'.format(platform.upper()) for platform in platforms)
+        lines.append('{} {}'.format('#if' if i == 0 else '#elif', condition))
+        lines.append('#ifdef UI_SINGLE_LAYER')
+        lines.append('static const RenderStats s_frame_baseline = {};'.format(single_frame))
+        lines.append('#else')
+        lines.append('static const RenderStats s_frame_baseline = {};'.format(layers_frame))
+        lines.append('#endif')
+        lines.append('static const RenderStats s_image_baselines[SCORE_BUCKET_COUNT] = {')
+        for bucket, stats in zip(BUCKETS, images):
+            lines.append('    [{}] = {},'.format(bucket, stats))
+        lines.append('};')
+    lines.append('#else')
+    lines.append('#error "No render baselines for this platform, run make baselines in tools/host"')
+    lines.append('#endif')
+
+    with open(header_path, 'w') as header:
+        header.write('\n'.join(lines) + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""
+Checks the heap use a build made with `pebble build -- --memory-stats` logs.
+
+Pipe the app logs in, e.g. `pebble logs | tools/memory_stats_check.py`, after running the app through the stages
+to check: start up, the loading and main windows, score updates and exit. Prints the most heap used at each stage
+and exits non-zero when any stage went over its budget, or when no stage was logged at all.
+"""
+import re
+import sys
+
+STAGE_LINE = re.compile(r'\[MemoryStats\] (\w+) used=(\d+) free=(\d+) high_water=(\d+) budget=(\d+)')
+FAIL_LINE = re.compile(r'\[MemoryStats\] FAIL (.*)')
+
+
+def main():
+    stages = {}
+    failures = []
+    high_water = 0
+    for line in sys.stdin:
+        fail = FAIL_LINE.search(line)
+        if fail:
+            failures.append(fail.group(1))
+            continue
+
+        match = STAGE_LINE.search(line)
+        if not match:
+            continue
+        stage = match.group(1)
+        used, _, stage_high_water, budget = (int(value) for value in match.groups()[1:])
+        count, most_used, _ = stages.get(stage, (0, 0, budget))
+        stages[stage] = (count + 1, max(most_used, used), budget)
+        high_water = max(high_water, stage_high_water)
+
+    if not stages:
+        print('No [MemoryStats] lines read, was the app built with --memory-stats?')
+        sys.exit(1)
+
+    print('{:<24} {:>5} {:>9} {:>9}'.format('stage', 'count', 'max used', 'budget'))
+    for stage, (count, most_used, budget) in stages.items():
+        print('{:<24} {:>5} {:>9} {:>9}'.format(stage, count, most_used, budget))
+    print('high water {}'.format(high_water))
+
+    for failure in failures:
+        print('FAIL ' + failure)
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == '__main__':
+    main()
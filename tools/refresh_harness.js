@@ -0,0 +1,438 @@
+/**
+ * Measures the phone side of a refresh offline. Runs src/pkjs/index.js with stand-ins for the Pebble and
+ * XMLHttpRequest globals against forecast_server.js, with a simulated watch that answers 'ready' with an update
+ * request the way src/c/app/communication.c does and acknowledges every message. For each scenario it reports the
+ * wall clock time from 'ready' to the first scores reaching the watch and to the last message of a sync, the
+ * requests made and the bytes posted to the watch, next to the app's own "Refresh ..." stats lines.
+ *
+ *   node refresh_harness.js [--out refresh_results.md] [--ack-ms 30] [--only name] [--verbose]
+ *
+ * Scenarios run in order and later ones start from the local storage and watch state earlier ones left behind.
+ * The app's retry backoff is jittered with Math.random, so the error and timeout scenarios vary between runs.
+ */
+const fs = require('fs')
+const http = require('http')
+const os = require('os')
+const path = require('path')
+const vm = require('vm')
+const { createRequire } = require('module')
+
+const { createForecastServer } = require('./forecast_server.js')
+
+const indexPath = path.join(__dirname, '../src/pkjs/index.js')
+const indexSource = fs.readFileSync(indexPath, 'utf8')
+
+/**
+ * Protocol constants as the watch knows them, see src/c/app/protocol.h
+ */
+const protocolVersion = 5
+const opcodes = { ready: 1, updateAll: 2, timeline: 4, resync: 5, chunk: 6 }
+const syncFlags = { reset: 0x1, stale: 0x2, complete: 0x4, fetchFirst: 0x8 }
+const inboxSize = 128
+const chunkHeaderBytes = 7
+/**
+ * Longest a scenario may run, enough for every request of a cold refresh to time out and retry
+ */
+const scenarioLimitMs = 180000
+
+function parseArguments(argv) {
+    const options = { out: null, ackMs: 30, only: null, verbose: false }
+    for (let i = 0; i < argv.length; i++) {
+        if (argv[i] === '--out') options.out = argv[++i]
+        else if (argv[i] === '--ack-ms') options.ackMs = Number(argv[++i])
+        else if (argv[i] === '--only') options.only = argv[++i]
+        else if (argv[i] === '--verbose') options.verbose = true
+        else {
+            console.error('Unknown option ' + argv[i])
+            process.exit(2)
+        }
+    }
+    return options
+}
+
+/**
+ * The watch end of the AppMessage protocol: keeps the sequence of the last message it applied, reassembles chunked
+ * transfers and notes when the first scores and the last message of a sync arrive
+ */
+function createWatch(state, onReady) {
+    const transfers = {}
+    const watch = {
+        sequence: state.sequence,
+        // Scores restored from storage stay marked until a sync completes, see data.c
+        stale: state.sequence !== 0,
+        fetchFirst: state.fetchFirst,
+        firstDataAt: null,
+        completeAt: null,
+        completes: 0,
+    }
+
+    function apply(op, payload, receivedAt) {
+        if (payload[0] !== protocolVersion) throw new Error('Unexpected protocol version ' + payload[0])
+        if (watch.firstDataAt === null) watch.firstDataAt = receivedAt
+        watch.sequence = (payload[1] << 8) | payload[2]
+        if (payload[3] & syncFlags.complete) {
+            watch.stale = false
+            watch.completes++
+            watch.completeAt = receivedAt
+        }
+    }
+
+    watch.receive = function (message, receivedAt) {
+        const payload = message.payload || []
+        if (message.op === opcodes.ready) {
+            onReady()
+        } else if (message.op === opcodes.chunk) {
+            const id = payload[1]
+            const index = (payload[2] << 8) | payload[3]
+            const count = (payload[4] << 8) | payload[5]
+            const transfer = transfers[id] = transfers[id] || { chunks: new Array(count), received: 0 }
+            if (transfer.chunks[index] === undefined) transfer.received++
+            transfer.chunks[index] = payload.slice(1 + chunkHeaderBytes)
+            if (transfer.received === count) {
+                delete transfers[id]
+                const data = [].concat(...transfer.chunks)
+                apply(data[0], data.slice(1), receivedAt)
+            }
+        } else if (message.op === opcodes.timeline) {
+            apply(message.op, payload, receivedAt)
+        }
+    }
+
+    watch.createUpdateRequest = function () {
+        const flags = (watch.stale ? syncFlags.stale : 0) | (watch.fetchFirst ? syncFlags.fetchFirst : 0)
+        return {
+            op: opcodes.updateAll,
+            payload: [protocolVersion, watch.sequence >> 8, watch.sequence & 0xFF, flags, inboxSize >> 8,
+                inboxSize & 0xFF],
+        }
+    }
+    return watch
+}
+
+/**
+ * Runs index.js once in a fresh context, from 'ready' until nothing is left pending
+ * @param {Object} scenario - See scenarios below
+ * @param {Object<string, string>} storage - Local storage, updated in place
+ * @param {{sequence: number}} watchState - What the watch holds, updated in place
+ * @param {Object} options - Command line options
+ * @returns {Promise<Object>} Measurements of the run
+ */
+function runScenario(scenario, storage, watchState, options) {
+    return new Promise((resolve, reject) => {
+        const { server, stats: serverStats } = createForecastServer(scenario.server || {})
+        server.listen(0, '127.0.0.1', () => {
+            storage.apiBaseUrl = `http://127.0.0.1:${server.address().port}/v1/forecast`
+            if (scenario.samples !== undefined) storage.lineOfSightSamples = String(scenario.samples)
+            else delete storage.lineOfSightSamples
+            if (scenario.prepare) scenario.prepare(storage)
+
+            let pending = 0
+            const logs = []
+            const result = { requests: 0, bytesReceived: 0, messages: 0, bytesPosted: 0 }
+            const listeners = { ready: [], appmessage: [] }
+            let readyAt = 0
+
+            function track(callback) {
+                pending++
+                let done = false
+                return function () {
+                    if (done) return
+                    done = true
+                    pending--
+                    if (callback) callback.apply(this, arguments)
+                }
+            }
+
+            const watch = createWatch({ sequence: watchState.sequence, fetchFirst: Boolean(scenario.fetchFirst) },
+                () => {
+                    const request = watch.createUpdateRequest()
+                    setTimeout(track(() => {
+                        listeners.appmessage.forEach(listener => listener({ payload: request }))
+                    }), options.ackMs)
+                })
+
+            const timers = new Map()
+            const sandbox = {
+                console: {
+                    log: message => {
+                        logs.push({ at: Date.now() - readyAt, message: String(message) })
+                        if (options.verbose) console.log(message)
+                    },
+                },
+                setTimeout: (callback, delay) => {
+                    const untrack = track()
+                    const handle = setTimeout(() => {
+                        timers.delete(handle)
+                        untrack()
+                        callback()
+                    }, delay)
+                    timers.set(handle, untrack)
+                    return handle
+                },
+                clearTimeout: handle => {
+                    const untrack = timers.get(handle)
+                    if (untrack) {
+                        timers.delete(handle)
+                        untrack()
+                    }
+                    clearTimeout(handle)
+                },
+                localStorage: {
+                    getItem: key => Object.prototype.hasOwnProperty.call(storage, key) ? storage[key] : null,
+                    setItem: (key, value) => {
+                        storage[key] = String(value)
+                    },
+                    removeItem: key => {
+                        delete storage[key]
+                    },
+                },
+                Pebble: {
+                    on: (name, listener) => listeners[name].push(listener),
+                    addEventListener: (name, listener) => listeners[name].push(listener),
+                    getWatchToken: () => 'harness-watch',
+                    getTimelineToken: (onSuccess, onFailure) => onFailure('no timeline in the harness'),
+                    sendAppMessage: (message, onSuccess, onFailure) => {
+                        const copy = { op: message.op, payload: (message.payload || []).slice() }
+                        if (copy.op !== opcodes.ready) {
+                            result.messages++
+                            result.bytesPosted += copy.payload.length
+                        }
+                        setTimeout(track(() => {
+                            watch.receive(copy, Date.now() - readyAt)
+                            if (onSuccess) onSuccess({ data: message })
+                        }), options.ackMs)
+                    },
+                },
+                XMLHttpRequest: createXMLHttpRequest(track, result),
+                require: createRequire(indexPath),
+            }
+            vm.createContext(sandbox)
+            vm.runInContext(indexSource, sandbox, { filename: indexPath })
+
+            readyAt = Date.now()
+            listeners.ready.forEach(listener => listener({}))
+
+            let idleChecks = 0
+            const poll = setInterval(() => {
+                idleChecks = pending === 0 ? idleChecks + 1 : 0
+                const elapsed = Date.now() - readyAt
+                if (idleChecks < 2 && elapsed < scenarioLimitMs) return
+
+                clearInterval(poll)
+                server.close()
+                server.closeAllConnections()
+                if (pending !== 0) {
+                    reject(new Error(`${scenario.name} still had ${pending} callbacks pending after ${elapsed} ms`))
+                    return
+                }
+                watchState.sequence = watch.sequence
+                resolve(Object.assign(result, {
+                    name: scenario.name,
+                    description: scenario.description,
+                    firstDataMs: watch.firstDataAt,
+                    completeMs: watch.completeAt,
+                    completes: watch.completes,
+                    server: Object.assign({}, serverStats),
+                    refreshes: logs.filter(({ message }) => message.indexOf('Refresh ') >= 0)
+                        .map(({ message }) => message.replace('[PebbleKit JS]: ', '')),
+                }))
+            }, 10)
+        })
+    })
+}
+
+/**
+ * XMLHttpRequest over Node's http, as much of it as index.js uses
+ */
+function createXMLHttpRequest(track, result) {
+    return class {
+        open(method, url) {
+            this.method = method
+            this.url = url
+            this.headers = {}
+            this.status = 0
+            this.response = null
+        }
+
+        setRequestHeader(name, value) {
+            this.headers[name] = value
+        }
+
+        send(body) {
+            result.requests++
+            const settle = track()
+            this.settle = settle
+            this.request = http.request(this.url, { method: this.method, headers: this.headers }, response => {
+                const parts = []
+                response.on('data', part => parts.push(part))
+                response.on('end', () => {
+                    if (this.aborted) return
+                    this.status = response.statusCode
+                    this.response = Buffer.concat(parts).toString('utf8')
+                    result.bytesReceived += Buffer.byteLength(this.response)
+                    settle()
+                    if (this.onload) this.onload()
+                })
+            })
+            this.request.on('error', () => {
+                if (this.aborted) return
+                settle()
+                if (this.onerror) this.onerror()
+            })
+            if (body) this.request.write(body)
+            this.request.end()
+        }
+
+        abort() {
+            if (this.aborted || !this.request) return
+            this.aborted = true
+            this.request.destroy()
+            this.settle()
+        }
+    }
+}
+
+/**
+ * Moves every cached forecast back in time, as if the last fetch happened that long ago
+ */
+function ageCache(storage, ageMs) {
+    const cache = JSON.parse(storage.forecast)
+    Object.keys(cache.forecasts).forEach(key => {
+        cache.forecasts[key].fetchedAt = Date.now() - ageMs
+    })
+    storage.forecast = JSON.stringify(cache)
+}
+
+function clearStorage(storage, watchState) {
+    Object.keys(storage).forEach(key => delete storage[key])
+    watchState.sequence = 0
+}
+
+const hourMs = 60 * 60 * 1000
+const recordedPath = path.join(os.tmpdir(), 'refresh_harness_recorded.json')
+
+const scenarios = [
+    {
+        name: 'cold',
+        description: 'First launch, nothing cached, 150 ms upstream',
+        server: { latencyMs: 150 },
+        // Recorded for the replay scenario
+        after: storage => fs.writeFileSync(recordedPath, storage.forecast),
+        reset: true,
+    },
+    {
+        name: 'cached',
+        description: 'Relaunch with the forecast cached 5 minutes ago',
+        server: { latencyMs: 150 },
+        prepare: storage => ageCache(storage, 5 * 60 * 1000),
+    },
+    {
+        name: 'revalidate',
+        description: 'Relaunch with a 2 h old cache, served then fetched again in the background',
+        server: { latencyMs: 150 },
+        prepare: storage => ageCache(storage, 2 * hourMs),
+    },
+    {
+        name: 'quiet',
+        description: 'Background launch with a 2 h old cache, which fetches before syncing',
+        server: { latencyMs: 150 },
+        fetchFirst: true,
+        prepare: storage => ageCache(storage, 2 * hourMs),
+    },
+    {
+        name: 'replay',
+        description: 'First launch against forecasts recorded from the app cache, 150 ms upstream',
+        server: { latencyMs: 150, recorded: recordedPath },
+        prepare: () => fs.existsSync(recordedPath) || fs.writeFileSync(recordedPath, '{}'),
+        reset: true,
+    },
+    {
+        name: 'slow',
+        description: 'First launch, 2 s upstream',
+        server: { latencyMs: 2000 },
+        reset: true,
+    },
+    {
+        name: 'errors',
+        description: 'First launch, 150 ms upstream answering 30% of requests with status 500',
+        server: { latencyMs: 150, errorRate: 0.3, seed: 7 },
+        reset: true,
+    },
+    {
+        name: 'timeouts',
+        description: 'First launch, 150 ms upstream never answering 20% of requests',
+        server: { latencyMs: 150, timeoutRate: 0.2, seed: 3 },
+        reset: true,
+    },
+    {
+        name: 'line-of-sight',
+        description: 'First launch sampling 10 points per line of sight, 150 ms upstream',
+        server: { latencyMs: 150 },
+        samples: 10,
+        reset: true,
+    },
+]
+
+function formatMs(ms) {
+    return ms === null ? '-' : String(ms)
+}
+
+function formatResults(results, options) {
+    const lines = [
+        '# Refresh harness results',
+        '',
+        'Generated by `node tools/refresh_harness.js --out tools/refresh_results.md`, which runs src/pkjs/index.js',
+        'against tools/forecast_server.js with a simulated watch acknowledging each message after ' +
+        `${options.ackMs} ms.`,
+        `Node ${process.version} on ${os.platform()} ${os.arch()}, ${new Date().toISOString().slice(0, 10)}.`,
+        'Times are wall clock milliseconds from \'ready\'; first data is the first scores or timeline message the',
+        'watch applied, complete the last message of the last sync. Both include the simulated round trips before',
+        'the phone can send, the acknowledged ready message and the watch\'s update request, which the app\'s own',
+        'stats lines below start after. Requests count every attempt, retries included.',
+        '',
+        '| Scenario | First data ms | Complete ms | Syncs | Requests | Bytes received | Messages | Bytes posted |',
+        '|---|---:|---:|---:|---:|---:|---:|---:|',
+    ]
+    results.forEach(result => {
+        lines.push(`| ${result.name} | ${formatMs(result.firstDataMs)} | ${formatMs(result.completeMs)} | ` +
+            `${result.completes} | ${result.requests} | ${result.bytesReceived} | ${result.messages} | ` +
+            `${result.bytesPosted} |`)
+    })
+    lines.push('')
+    results.forEach(result => {
+        lines.push(`## ${result.name}`, '', result.description + '.', '')
+        lines.push(`Server: ${result.server.requests} requests, ${result.server.errors} errors, ` +
+            `${result.server.timeouts} left unanswered, ${result.server.locations} locations ` +
+            `(${result.server.recordedLocations} recorded).`, '')
+        lines.push('```')
+        result.refreshes.forEach(line => lines.push(line))
+        lines.push('```', '')
+    })
+    return lines.join('\n')
+}
+
+async function main() {
+    const options = parseArguments(process.argv.slice(2))
+    const storage = {}
+    const watchState = { sequence: 0 }
+    const results = []
+    for (const scenario of scenarios) {
+        if (scenario.reset) clearStorage(storage, watchState)
+        if (options.only && scenario.name !== options.only) continue
+        console.log(`[RefreshHarness] ${scenario.name}: ${scenario.description}`)
+        const result = await runScenario(scenario, storage, watchState, options)
+        if (scenario.after) scenario.after(storage)
+        console.log(`[RefreshHarness] ${scenario.name}: first data ${formatMs(result.firstDataMs)} ms, complete ` +
+            `${formatMs(result.completeMs)} ms, ${result.requests} requests, ${result.bytesPosted} bytes posted`)
+        results.push(result)
+    }
+
+    const report = formatResults(results, options)
+    if (options.out) fs.writeFileSync(options.out, report)
+    else console.log(report)
+}
+
+main().catch(error => {
+    console.error('[RefreshHarness] ' + error.message)
+    process.exit(1)
+})
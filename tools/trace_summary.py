@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""
+Summarises the trace points a build made with `pebble build -- --trace` logs.
+
+Pipe the app logs in, e.g. `pebble logs | tools/trace_summary.py`, then long press select on the main window
+or close the app to dump the trace. Each phase is timed from a point to the next occurrence of its end point in
+the same dump, unless its start point or one of the points that interrupt it comes first, and reported across
+every dump read.
+"""
+import re
+import sys
+
+# (phase, from point, to point, points that interrupt it). The watch asks for scores at launch, which goes nowhere
+# until the phone is ready, and again in answer to the phone's ready, traced as ready_update_sent. Refreshes after
+# that are update_sent, and a payload only answers one if no other request went out in between.
+PHASES = [
+    ('startup: init', 'main', 'init_done', ()),
+    ('startup: phone ready', 'init_done', 'ready_received', ()),
+    ('round trip: request', 'ready_received', 'ready_update_sent', ()),
+    ('round trip: scores', 'ready_update_sent', 'payload_applied', ('update_sent',)),
+    ('refresh: scores', 'update_sent', 'payload_applied', ('ready_received', 'ready_update_sent')),
+    ('startup: main window', 'payload_applied', 'main_window_shown', ()),
+    ('startup: total', 'main', 'main_window_shown', ()),
+    ('click to paint', 'click', 'frame_drawn', ()),
+]
+
+TRACE_LINE = re.compile(r'\[Trace\] (\w+)(?: (\d+))?')
+
+
+def read_dumps(lines):
+    dump = []
+    for line in lines:
+        match = TRACE_LINE.search(line)
+        if not match:
+            continue
+        if match.group(1) == 'end':
+            yield dump
+            dump = []
+        elif match.group(2) is not None:
+            dump.append((match.group(1), int(match.group(2))))
+
+
+def measure(dump, start, end, interrupts):
+    durations = []
+    for i, (point, ms) in enumerate(dump):
+        if point != start:
+            continue
+        for later_point, later_ms in dump[i + 1:]:
+            if later_point == end:
+                durations.append(later_ms - ms)
+                break
+            if later_point == start or later_point in interrupts:
+                break
+    return durations
+
+
+def main():
+    durations = {phase: [] for phase, _, _, _ in PHASES}
+    for dump in read_dumps(sys.stdin):
+        for phase, start, end, interrupts in PHASES:
+            durations[phase].extend(measure(dump, start, end, interrupts))
+
+    print('{:<24} {:>5} {:>7} {:>7} {:>7}'.format('phase', 'count', 'min', 'median', 'max'))
+    for phase, _, _, _ in PHASES:
+        values = sorted(durations[phase])
+        if not values:
+            print('{:<24} {:>5}'.format(phase, 0))
+            continue
+        print('{:<24} {:>5} {:>5}ms {:>5}ms {:>5}ms'.format(phase, len(values), values[0],
+                                                          values[len(values) // 2], values[-1]))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,112 @@
+#include <pebble_worker.h>
+#include "../../src/c/app/persist.h"
+
+// Workers cannot talk to the phone, so the worker launches the app, which refreshes and closes itself again.
+// While the worker runs it stands in for the app's wakeups, see src/c/app/scheduler.c: it launches at the same
+// slots before each viewing period, but only when the launch would bring newer scores and nothing disturbs.
+// Slots are skipped once this far past, a worker started later in the day waits for the next one
+#define SLOT_WINDOW_S QUIET_LAUNCH_LEAD_S
+// Minute ticks run from this long before a slot until its window closes, hour ticks are enough to see one coming
+#define MINUTE_TICKS_LEAD_S SECONDS_PER_HOUR
+#define MIN_BATTERY_PERCENT 30
+
+static const int s_slot_hours[] = {MORNING_START_HOUR, AFTERNOON_START_HOUR};
+static TimeUnits s_tick_unit;
+
+// The slot whose window is open now or opens within the given lead, 0 when there is none
+static time_t get_slot(time_t now, time_t lead)
+{
+    const time_t day_start = now - (now + JST_OFFSET_SECONDS) % SECONDS_PER_DAY;
+    for (size_t i = 0; i < sizeof(s_slot_hours) / sizeof(s_slot_hours[0]); i++)
+    {
+        const time_t slot = day_start + s_slot_hours[i] * SECONDS_PER_HOUR - QUIET_LAUNCH_LEAD_S;
+        if (slot - lead <= now && now < slot + SLOT_WINDOW_S)
+            return slot;
+    }
+    return 0;
+}
+
+// The slot at or before now that is still within its window, 0 when there is none
+static time_t get_due_slot(time_t now)
+{
+    return get_slot(now, 0);
+}
+
+static bool can_launch(void)
+{
+#if PBL_API_EXISTS(quiet_time_is_active)
+    // Popping the app up would light the screen the user asked to keep dark
+    if (quiet_time_is_active())
+        return false;
+#endif
+
+    // The app could not reach the phone anyway
+    if (!connection_service_peek_pebble_app_connection())
+        return false;
+
+    // A low battery is worth more than fresher scores
+    BatteryChargeState charge = battery_state_service_peek();
+    return charge.is_charging || charge.is_plugged || charge.charge_percent >= MIN_BATTERY_PERCENT;
+}
+
+// Read on every check, since the app records its own quiet launches and saves scores while the worker runs
+static bool is_launch_due(time_t now)
+{
+    PersistedScores scores;
+    int32_t fetched_at = 0;
+    if (persist_read_data(PERSIST_KEY_SCORES, &scores, sizeof(scores)) == sizeof(scores) &&
+        scores.version == PERSIST_SCORES_VERSION)
+    {
+        fetched_at = scores.fetched_at;
+    }
+
+    PersistedWorker worker = {0};
+    persist_read_data(PERSIST_KEY_WORKER, &worker, sizeof(worker));
+    return is_quiet_launch_due(fetched_at, worker.last_launch, (int32_t)now);
+}
+
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed);
+
+// Ticks wake the worker, so it only asks for one a minute around the slots
+static void subscribe_ticks(time_t now)
+{
+    const TimeUnits unit = get_slot(now, MINUTE_TICKS_LEAD_S) ? MINUTE_UNIT : HOUR_UNIT;
+    if (unit == s_tick_unit)
+        return;
+
+    s_tick_unit = unit;
+    tick_timer_service_subscribe(unit, tick_handler);
+}
+
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed)
+{
+    const time_t now = time(NULL);
+    subscribe_ticks(now);
+    if (get_due_slot(now) == 0 || !can_launch() || !is_launch_due(now))
+        return;
+
+    // Recorded first, so neither this worker nor a wakeup launches again while the app refreshes
+    PersistedWorker worker = {0};
+    persist_read_data(PERSIST_KEY_WORKER, &worker, sizeof(worker));
+    worker.last_launch = (int32_t)now;
+    persist_write_data(PERSIST_KEY_WORKER, &worker, sizeof(worker));
+    worker_launch_app();
+}
+
+static void init(void)
+{
+    subscribe_ticks(time(NULL));
+}
+
+static void deinit(void)
+{
+    tick_timer_service_unsubscribe();
+}
+
+int main(void)
+{
+    init();
+    worker_event_loop();
+    deinit();
+    return 0;
+}